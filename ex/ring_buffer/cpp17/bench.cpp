@@ -0,0 +1,71 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "bench.hpp"
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+SCENARIO("Benchmark harness: latency percentiles") {
+  GIVEN("a recorder with the samples 1 to 1000") {
+    my::bench::Latency_recorder recorder{1000};
+    for (std::uint64_t i = 1000; i > 0; i--) {
+      // record() subtracts the clock overhead; add it back
+      recorder.record(i + my::bench::Tick_clock::overhead());
+    }
+    WHEN("reading the percentiles at one nanosecond per tick") {
+      const auto latency = recorder.percentiles(1.0);
+      THEN("they are the nearest-rank samples") {
+        CHECK(recorder.done());
+        CHECK(latency.p50 == 500);
+        CHECK(latency.p90 == 900);
+        CHECK(latency.p99 == 990);
+        CHECK(latency.p999 == 999);
+        CHECK(latency.max == 1000);
+        CHECK(recorder.total_ns(1.0) == 500'500);
+      }
+    }
+  }
+}
+
+SCENARIO("Benchmark harness: throughput") {
+  GIVEN("a body that counts its iterations") {
+    std::uint64_t total = 0;
+    auto body = [&total](std::uint64_t iterations) {
+      for (std::uint64_t i = 0; i < iterations; i++) {
+        my::bench::do_not_optimize(total += 1);
+      }
+    };
+    WHEN("measuring it for at least 10 ms") {
+      const auto result = my::bench::measure({"count", 1, 8}, body, 0.01);
+      THEN("the last run took at least that long") {
+        CHECK(result.iterations > 1);
+        CHECK(result.real_ns >= 1e7);
+        CHECK(total >= result.iterations);
+        CHECK(!result.latency);
+      }
+    }
+  }
+}
+
+SCENARIO("Benchmark harness: JSON output") {
+  GIVEN("a result whose name needs escaping") {
+    my::bench::Result result{{"a \"quoted\" name", 2, 64}, 10, 100, 200, {}};
+    result.latency = my::bench::Latency{1, 2, 3, 4, 5};
+    WHEN("writing it") {
+      std::ostringstream os;
+      my::bench::write_json(os, {result});
+      const auto json = os.str();
+      THEN("it has the fields of Google Benchmark and the latencies") {
+        CHECK(json.find(R"("name": "a \"quoted\" name")") != std::string::npos);
+        CHECK(json.find(R"("iterations": 10)") != std::string::npos);
+        CHECK(json.find(R"("real_time": 10)") != std::string::npos);
+        CHECK(json.find(R"("cpu_time": 20)") != std::string::npos);
+        CHECK(json.find(R"("time_unit": "ns")") != std::string::npos);
+        CHECK(json.find(R"("threads": 2)") != std::string::npos);
+        CHECK(json.find(R"("payload_bytes": 64)") != std::string::npos);
+        CHECK(json.find(R"("p999_ns": 4)") != std::string::npos);
+      }
+    }
+  }
+}
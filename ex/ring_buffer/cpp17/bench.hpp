@@ -0,0 +1,490 @@
+#pragma once
+
+/**
+ * @brief A self-contained microbenchmark harness in the spirit of
+ * Google Benchmark, small enough to need nothing but the standard
+ * library (and POSIX threads).
+ *
+ * A benchmark is a callable registered with a Suite under a Config
+ * (name, number of threads, payload size). There are two kinds:
+ * - `Suite::add()` registers a throughput benchmark `body(iterations)`
+ *   that performs that many operations. The harness calls it with a
+ *   growing number of iterations until one run takes at least
+ *   `--min-time` seconds, and reports the time per operation of that
+ *   run.
+ * - `Suite::add_latency()` registers a latency benchmark
+ *   `body(recorder)` that times each operation by passing it to
+ *   `recorder.measure()`, until `recorder.done()`. The harness
+ *   reports the 50th, 90th, 99th and 99.9th percentile and the
+ *   maximum.
+ *
+ * `Suite::main()` runs the benchmarks whose name contains `--filter`,
+ * reports progress on stderr and writes the results as JSON to stdout
+ * (or to `--out`). The JSON has the layout of Google Benchmark's
+ * `--benchmark_format=json`, so its compare tools can diff two runs.
+ * Times are in nanoseconds per operation; cpu_time is the CPU time of
+ * the whole process, i.e. summed over all threads.
+ *
+ * Per-operation latencies are read from the time-stamp counter on
+ * x86-64 and from std::chrono::steady_clock elsewhere; the overhead of
+ * reading the clock is measured once and subtracted from every sample.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace my::bench {
+
+/**
+ * Keeps the compiler from optimizing away the computation of a value.
+ */
+template<typename T>
+void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * A trivially copyable element of exactly Size bytes.
+ */
+template<std::size_t Size>
+struct Payload {
+  std::array<std::byte, Size> bytes;
+};
+
+/**
+ * The name and dimensions of a benchmark, as reported in the JSON.
+ */
+struct Config {
+  std::string name;
+  std::size_t threads{1};
+  std::size_t payload_bytes{0};
+};
+
+/**
+ * Latency percentiles in nanoseconds.
+ */
+struct Latency {
+  double p50{0};
+  double p90{0};
+  double p99{0};
+  double p999{0};
+  double max{0};
+};
+
+struct Result {
+  Config config;
+  std::uint64_t iterations{0};
+  double real_ns{0};
+  double cpu_ns{0};
+  std::optional<Latency> latency;
+
+  double real_ns_per_op() const { return real_ns / static_cast<double>(iterations); }
+  double cpu_ns_per_op() const { return cpu_ns / static_cast<double>(iterations); }
+  double ops_per_second() const { return 1e9 / real_ns_per_op(); }
+};
+
+/**
+ * A cheap clock for timing single operations. Its ticks are converted
+ * to nanoseconds with a ratio calibrated against steady_clock.
+ */
+class Tick_clock {
+public:
+  static std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    const auto t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  static double ns_per_tick() {
+    static const double ratio = calibrate();
+    return ratio;
+  }
+
+  /**
+   * The smallest number of ticks between two consecutive readings.
+   */
+  static std::uint64_t overhead() {
+    static const std::uint64_t ticks = [] {
+      auto least = UINT64_MAX;
+      for (int i = 0; i < 10'000; i++) {
+        const auto t0 = now();
+        const auto t1 = now();
+        least = std::min(least, t1 - t0);
+      }
+      return least;
+    }();
+    return ticks;
+  }
+
+private:
+  static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+    const auto t0 = now();
+    while (steady_clock::now() - start < milliseconds{20}) {
+    }
+    const auto t1 = now();
+    const duration<double, std::nano> elapsed = steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(t1 - t0);
+#else
+    using period = std::chrono::steady_clock::period;
+    return 1e9 * period::num / period::den;
+#endif
+  }
+};
+
+/**
+ * Collects the latency of up to `samples` operations.
+ */
+class Latency_recorder {
+public:
+  explicit Latency_recorder(std::size_t samples) : capacity{samples} {
+    ticks.reserve(samples);
+  }
+
+  /**
+   * Calls op() and records how long it took.
+   */
+  template<typename F>
+  void measure(F&& op) {
+    const auto t0 = Tick_clock::now();
+    op();
+    const auto t1 = Tick_clock::now();
+    record(t1 - t0);
+  }
+
+  /**
+   * Records a sample of the given number of clock ticks.
+   */
+  void record(std::uint64_t elapsed) {
+    const auto overhead = Tick_clock::overhead();
+    ticks.push_back(elapsed > overhead ? elapsed - overhead : 0);
+  }
+
+  bool done() const { return ticks.size() >= capacity; }
+  std::size_t size() const { return ticks.size(); }
+
+  /**
+   * Sorts the samples and reads the nearest-rank percentiles.
+   *
+   * @param ns_per_tick The length of a clock tick in nanoseconds.
+   */
+  Latency percentiles(double ns_per_tick = Tick_clock::ns_per_tick()) {
+    if (ticks.empty()) {
+      return {};
+    }
+    std::sort(ticks.begin(), ticks.end());
+    const auto at = [&](double p) {
+      const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(ticks.size())));
+      return static_cast<double>(ticks[std::max<std::size_t>(rank, 1) - 1]) * ns_per_tick;
+    };
+    return {at(0.5), at(0.9), at(0.99), at(0.999), at(1.0)};
+  }
+
+  /**
+   * The sum of all samples in nanoseconds.
+   */
+  double total_ns(double ns_per_tick = Tick_clock::ns_per_tick()) const {
+    std::uint64_t sum = 0;
+    for (auto t : ticks) {
+      sum += t;
+    }
+    return static_cast<double>(sum) * ns_per_tick;
+  }
+
+private:
+  std::size_t capacity;
+  std::vector<std::uint64_t> ticks;
+};
+
+/**
+ * Pins the calling thread to the given CPU, modulo the number of CPUs.
+ * Does nothing where that is not supported.
+ */
+inline void pin_to_cpu([[maybe_unused]] std::size_t cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+/**
+ * Runs body(i) for i in [0, n) on n threads, each pinned to its own
+ * CPU, released at the same time once all of them have started.
+ */
+template<typename F>
+void run_threads(std::size_t n, F&& body) {
+  std::atomic<std::size_t> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  threads.reserve(n);
+  for (std::size_t i = 0; i < n; i++) {
+    threads.emplace_back([&, i] {
+      pin_to_cpu(i);
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      body(i);
+    });
+  }
+  while (ready.load() < n) {
+    std::this_thread::yield();
+  }
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * Runs body(iterations) with a growing number of iterations until a
+ * run takes at least min_seconds.
+ */
+template<typename F>
+Result measure(Config config, F&& body, double min_seconds) {
+  std::uint64_t iterations = 1;
+  for (;;) {
+    const auto cpu_start = std::clock();
+    const auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+    const double cpu_ns = 1e9 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    constexpr std::uint64_t max_iterations = 1'000'000'000;
+    if (elapsed.count() >= min_seconds * 1e9 || iterations >= max_iterations) {
+      return {std::move(config), iterations, elapsed.count(), cpu_ns, {}};
+    }
+    // aim 40% past the goal, but grow by at most 10x at a time
+    const double scale = elapsed.count() > 0 ? 1.4 * min_seconds * 1e9 / elapsed.count() : 10;
+    const auto next = static_cast<std::uint64_t>(static_cast<double>(iterations) * std::min(scale, 10.0));
+    iterations = std::min(std::max(next, iterations + 1), max_iterations);
+  }
+}
+
+/**
+ * Runs body(recorder) once with room for the given number of samples.
+ */
+template<typename F>
+Result measure_latency(Config config, std::size_t samples, F&& body) {
+  Latency_recorder recorder{samples};
+  const auto cpu_start = std::clock();
+  body(recorder);
+  const double cpu_ns = 1e9 * static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  const auto iterations = std::max<std::uint64_t>(recorder.size(), 1);
+  const auto real_ns = recorder.total_ns();
+  return {std::move(config), iterations, real_ns, std::min(cpu_ns, real_ns), recorder.percentiles()};
+}
+
+/**
+ * Writes s as a JSON string literal.
+ */
+inline void write_json_string(std::ostream& os, std::string_view s) {
+  os << '"';
+  for (char c : s) {
+    switch (c) {
+    case '"': os << "\\\""; break;
+    case '\\': os << "\\\\"; break;
+    case '\n': os << "\\n"; break;
+    case '\t': os << "\\t"; break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+          << static_cast<int>(c) << std::dec << std::setfill(' ');
+      } else {
+        os << c;
+      }
+    }
+  }
+  os << '"';
+}
+
+/**
+ * Writes the results in the JSON layout of Google Benchmark.
+ */
+inline void write_json(std::ostream& os, const std::vector<Result>& results) {
+  const auto now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%FT%T%z", std::localtime(&now));
+
+  os << std::setprecision(std::numeric_limits<double>::max_digits10);
+  os << "{\n  \"context\": {\n";
+  os << "    \"date\": ";
+  write_json_string(os, date);
+  os << ",\n    \"num_cpus\": " << std::thread::hardware_concurrency();
+#ifdef NDEBUG
+  os << ",\n    \"library_build_type\": \"release\"";
+#else
+  os << ",\n    \"library_build_type\": \"debug\"";
+#endif
+  os << "\n  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const auto& r = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\n      \"name\": ";
+    write_json_string(os, r.config.name);
+    os << ",\n      \"run_name\": ";
+    write_json_string(os, r.config.name);
+    os << ",\n      \"run_type\": \"iteration\""
+      << ",\n      \"iterations\": " << r.iterations
+      << ",\n      \"real_time\": " << r.real_ns_per_op()
+      << ",\n      \"cpu_time\": " << r.cpu_ns_per_op()
+      << ",\n      \"time_unit\": \"ns\""
+      << ",\n      \"threads\": " << r.config.threads
+      << ",\n      \"payload_bytes\": " << r.config.payload_bytes
+      << ",\n      \"items_per_second\": " << r.ops_per_second();
+    if (r.latency) {
+      os << ",\n      \"p50_ns\": " << r.latency->p50
+        << ",\n      \"p90_ns\": " << r.latency->p90
+        << ",\n      \"p99_ns\": " << r.latency->p99
+        << ",\n      \"p999_ns\": " << r.latency->p999
+        << ",\n      \"max_ns\": " << r.latency->max;
+    }
+    os << "\n    }";
+  }
+  os << "\n  ]\n}\n";
+}
+
+/**
+ * A list of benchmarks and the command line that runs them.
+ */
+class Suite {
+public:
+  /**
+   * Registers a throughput benchmark.
+   *
+   * @param config The name and dimensions of the benchmark.
+   * @param body Performs the given number of operations.
+   */
+  template<typename F>
+  void add(Config config, F body) {
+    benchmarks.push_back({config.name, [config, body](double min_seconds) {
+      return measure(config, body, min_seconds);
+    }});
+  }
+
+  /**
+   * Registers a latency benchmark.
+   *
+   * @param config The name and dimensions of the benchmark.
+   * @param samples The number of operations to time.
+   * @param body Times operations with a Latency_recorder until it is done.
+   */
+  template<typename F>
+  void add_latency(Config config, std::size_t samples, F body) {
+    benchmarks.push_back({config.name, [config, samples, body](double) {
+      return measure_latency(config, samples, body);
+    }});
+  }
+
+  /**
+   * Runs the benchmarks selected by the command line:
+   *     --filter=<substring>  only the benchmarks whose name contains it
+   *     --min-time=<seconds>  how long a throughput run takes at least
+   *     --out=<file>          where the JSON goes instead of stdout
+   *     --list                prints the names and runs nothing
+   *
+   * @return The exit status of the program.
+   */
+  int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string out;
+    double min_seconds = 0.5;
+    bool list = false;
+    for (int i = 1; i < argc; i++) {
+      const std::string_view arg{argv[i]};
+      if (arg.starts_with("--filter=")) {
+        filter = arg.substr(9);
+      } else if (arg.starts_with("--min-time=")) {
+        min_seconds = std::stod(std::string{arg.substr(11)});
+      } else if (arg.starts_with("--out=")) {
+        out = arg.substr(6);
+      } else if (arg == "--list") {
+        list = true;
+      } else {
+        std::cerr << "usage: " << argv[0]
+          << " [--filter=<substring>] [--min-time=<seconds>] [--out=<file>] [--list]\n";
+        return 2;
+      }
+    }
+
+    std::vector<Result> results;
+    for (const auto& benchmark : benchmarks) {
+      if (benchmark.name.find(filter) == std::string::npos) {
+        continue;
+      }
+      if (list) {
+        std::cout << benchmark.name << '\n';
+        continue;
+      }
+      results.push_back(benchmark.run(min_seconds));
+      report(std::cerr, results.back());
+    }
+    if (list) {
+      return 0;
+    }
+    if (out.empty()) {
+      write_json(std::cout, results);
+    } else {
+      std::ofstream file{out};
+      write_json(file, results);
+      if (!file) {
+        std::cerr << "cannot write " << out << '\n';
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+private:
+  static void report(std::ostream& os, const Result& r) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2) << std::left << std::setw(56) << r.config.name
+      << std::right << std::setw(10) << r.real_ns_per_op() << " ns/op";
+    if (r.latency) {
+      line << "  p50 " << r.latency->p50 << "  p99 " << r.latency->p99
+        << "  p99.9 " << r.latency->p999 << " ns";
+    }
+    os << line.str() << '\n';
+  }
+
+  struct Benchmark {
+    std::string name;
+    std::function<Result(double)> run;
+  };
+  std::vector<Benchmark> benchmarks;
+};
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace my {
+
+/**
+ * The minimum offset between two objects that avoids false sharing.
+ *
+ * GCC warns about every use of the standard constant in a header,
+ * since its value depends on -mtune; it is read once here instead.
+ * Standard libraries that do not provide it get the common 64 bytes.
+ */
+#ifdef __cpp_lib_hardware_interference_size
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+}
@@ -0,0 +1,141 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "channel.hpp"
+#include "executor.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::size_t allocations = 0;
+
+my::Task producer(my::Channel<int, 4>& chan, int count, std::vector<std::string>& log) {
+  for (int i = 0; i < count; i++) {
+    co_await chan.push(i);
+    log.push_back("pushed " + std::to_string(i));
+  }
+}
+
+my::Task consumer(my::Channel<int, 4>& chan, int count, std::vector<int>& received) {
+  for (int i = 0; i < count; i++) {
+    received.push_back(co_await chan.pop());
+  }
+}
+
+my::Task sum(my::Channel<int, 4>& chan, int count, long& total) {
+  for (int i = 0; i < count; i++) {
+    total += co_await chan.pop();
+  }
+}
+
+my::Task count_up(my::Channel<int, 4>& chan, int count) {
+  for (int i = 0; i < count; i++) {
+    co_await chan.push(i);
+  }
+}
+
+/**
+ * Counts the allocations made while the tasks exchange count messages.
+ */
+std::size_t allocations_for(int count) {
+  my::Channel<int, 4> chan;
+  my::Executor executor;
+  long total = 0;
+  executor.spawn(sum(chan, count, total));
+  executor.spawn(count_up(chan, count));
+  const auto before = allocations;
+  executor.run();
+  CHECK(total == static_cast<long>(count) * (count - 1) / 2);
+  return allocations - before;
+}
+
+}
+
+// not inlined, lest GCC pair the malloc() with a delete-expression
+[[gnu::noinline]] void* operator new(std::size_t size) {
+  allocations++;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+// not inlined, lest GCC pair the free() with a new-expression
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+SCENARIO("Channel: coroutines on both sides") {
+  GIVEN("a four-element channel") {
+    my::Channel<int, 4> chan;
+    my::Executor executor;
+    std::vector<std::string> log;
+    std::vector<int> received;
+    WHEN("the producer pushes six elements and nobody pops") {
+      executor.spawn(producer(chan, 6, log));
+      executor.run();
+      THEN("the producer suspends on the fifth push") {
+        CHECK(log.size() == 4);
+        CHECK(!executor.all_done());
+      }
+      AND_WHEN("a consumer pops all six") {
+        executor.spawn(consumer(chan, 6, received));
+        executor.run();
+        THEN("the consumer resumes the producer directly") {
+          CHECK(executor.all_done());
+          CHECK(log.size() == 6);
+        }
+        THEN("the elements arrive in order") {
+          CHECK(received == std::vector{0, 1, 2, 3, 4, 5});
+        }
+      }
+    }
+    WHEN("the consumer starts first") {
+      executor.spawn(consumer(chan, 3, received));
+      executor.run();
+      THEN("it suspends on the empty channel") {
+        CHECK(received.empty());
+        CHECK(!executor.all_done());
+      }
+      AND_WHEN("a producer pushes three elements") {
+        executor.spawn(producer(chan, 3, log));
+        executor.run();
+        THEN("each element is handed to the consumer directly") {
+          CHECK(executor.all_done());
+          CHECK(received == std::vector{0, 1, 2});
+        }
+      }
+    }
+  }
+  GIVEN("several producers and consumers on one channel") {
+    my::Channel<int, 4> chan;
+    my::Executor executor;
+    long total = 0;
+    WHEN("three producers push 100 elements each") {
+      for (int i = 0; i < 3; i++) {
+        executor.spawn(count_up(chan, 100));
+      }
+      for (int i = 0; i < 2; i++) {
+        executor.spawn(sum(chan, 150, total));
+      }
+      executor.run();
+      THEN("two consumers pop all of them") {
+        CHECK(executor.all_done());
+        CHECK(total == 3 * 4950);
+      }
+    }
+  }
+}
+SCENARIO("Channel: no allocation per message") {
+  GIVEN("a producer and a consumer task") {
+    WHEN("they exchange 10 and 10,000 messages") {
+      const auto few = allocations_for(10);
+      const auto many = allocations_for(10'000);
+      THEN("both runs allocate the same, i.e. nothing") {
+        CHECK(few == many);
+        CHECK(many == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,171 @@
+/**
+ * @brief Channel is a bounded FIFO queue between C++20 coroutines that
+ * can store at most N elements of type T.
+ *
+ * `co_await chan.push(e)` moves e into the channel, and suspends the
+ * calling coroutine while the channel is full. `co_await chan.pop()`
+ * returns the oldest element, and suspends the calling coroutine while
+ * the channel is empty. No coroutine ever polls.
+ *
+ * A suspended coroutine is resumed directly by the coroutine on the
+ * other side, on the same thread, as part of its `co_await`:
+ * - a push into an empty channel with a waiting popper hands the
+ *   element to that popper and resumes it;
+ * - a pop from a full channel with a waiting pusher moves that pusher's
+ *   element into the freed slot and resumes it.
+ * Waiters are resumed in the order they suspended.
+ *
+ * The elements are kept in a Ring_buffer, so they are stored directly
+ * within the Channel object. A suspended push keeps its element, and a
+ * suspended pop its result, in the awaiter object, which lives in the
+ * coroutine frame; the waiting lists are linked through the awaiters.
+ * So nothing is allocated per message.
+ *
+ * Channel is not thread-safe: all coroutines using it must run on one
+ * thread, e.g. under my::Executor (see executor.hpp). It must not be
+ * destroyed while a coroutine is suspended on it.
+ */
+#pragma once
+
+#include "ring_buffer.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace my {
+
+/**
+ * Bounded FIFO queues between coroutines.
+ *
+ * @tparam T The element stored in a built-in buffer.
+ * @tparam N The maximum number of elements in the buffer.
+ */
+template<typename T, std::size_t N>
+class Channel {
+  /**
+   * FIFO of suspended awaiters, linked through their `next` member.
+   */
+  template<typename Awaiter>
+  struct Waiters {
+    Awaiter* head{nullptr};
+    Awaiter* tail{nullptr};
+
+    void push_back(Awaiter* a) {
+      a->next = nullptr;
+      (tail ? tail->next : head) = a;
+      tail = a;
+    }
+    Awaiter* pop_front() {
+      Awaiter* a = head;
+      if (a) {
+        head = a->next;
+        if (!head) {
+          tail = nullptr;
+        }
+      }
+      return a;
+    }
+  };
+
+public:
+  Channel() = default;
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  class Push_awaiter {
+  public:
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    void await_resume() {}
+
+  private:
+    friend class Channel;
+    Push_awaiter(Channel& chan, T&& e) : channel{chan}, element{std::move(e)} {}
+
+    Channel& channel;
+    T element;
+    std::coroutine_handle<> handle;
+    Push_awaiter* next{nullptr};
+  };
+
+  class Pop_awaiter {
+  public:
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    T await_resume() { return std::move(*result); }
+
+  private:
+    friend class Channel;
+    explicit Pop_awaiter(Channel& chan) : channel{chan} {}
+
+    Channel& channel;
+    std::optional<T> result;
+    std::coroutine_handle<> handle;
+    Pop_awaiter* next{nullptr};
+  };
+
+  /**
+   * Moves the argument into the channel, or into a waiting popper.
+   * Awaiting the result suspends while the channel is full.
+   *
+   * @param e The element to be moved into the channel.
+   */
+  Push_awaiter push(T e) { return Push_awaiter{*this, std::move(e)}; }
+
+  /**
+   * Takes the oldest element out of the channel. Awaiting the result
+   * suspends while the channel is empty, and yields the element.
+   */
+  Pop_awaiter pop() { return Pop_awaiter{*this}; }
+
+  private:
+  Ring_buffer<T, N, Reject> buffer;
+  Waiters<Push_awaiter> pushers;
+  Waiters<Pop_awaiter> poppers;
+};
+
+/**
+ * Poppers wait only while the buffer is empty, so handing the element
+ * to the first of them keeps the FIFO order.
+ */
+template<typename T, std::size_t N>
+bool Channel<T, N>::Push_awaiter::await_ready() {
+  if (auto* popper = channel.poppers.pop_front()) {
+    popper->result.emplace(std::move(element));
+    popper->handle.resume();
+    return true;
+  }
+  return channel.buffer.try_push(std::move(element));
+}
+
+template<typename T, std::size_t N>
+void Channel<T, N>::Push_awaiter::await_suspend(std::coroutine_handle<> h) {
+  handle = h;
+  channel.pushers.push_back(this);
+}
+
+/**
+ * Pushers wait only while the buffer is full, so the slot freed here
+ * goes to the first of them.
+ */
+template<typename T, std::size_t N>
+bool Channel<T, N>::Pop_awaiter::await_ready() {
+  result = channel.buffer.pop();
+  if (!result) {
+    return false;
+  }
+  if (auto* pusher = channel.pushers.pop_front()) {
+    channel.buffer.try_push(std::move(pusher->element));
+    pusher->handle.resume();
+  }
+  return true;
+}
+
+template<typename T, std::size_t N>
+void Channel<T, N>::Pop_awaiter::await_suspend(std::coroutine_handle<> h) {
+  handle = h;
+  channel.poppers.push_back(this);
+}
+
+}
@@ -0,0 +1,104 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "dynamic_ring_buffer.hpp"
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+SCENARIO("Dynamic ring buffer: heap storage") {
+  GIVEN("a buffer for five strings") {
+    my::Dynamic_ring_buffer<std::string> buffer{5};
+    THEN("its capacity is exactly five") {
+      CHECK(buffer.capacity() == 5);
+    }
+    WHEN("pushing 0, 1, ..., 6") {
+      for (int i = 0; i < 7; i++) {
+        buffer.push(std::to_string(i));
+      }
+      THEN("you get the last five elements in order") {
+        CHECK(buffer.size() == 5);
+        CHECK(buffer.pop().value() == "2");
+        CHECK(buffer.pop().value() == "3");
+        CHECK(buffer.pop().value() == "4");
+        CHECK(buffer.pop().value() == "5");
+        CHECK(buffer.pop().value() == "6");
+        CHECK(!buffer.pop());
+      }
+      THEN("the live region is split at the wrap-around") {
+        const auto [first, second] = buffer.peek_contiguous();
+        CHECK(first.size() == 3);
+        CHECK(second.size() == 2);
+        CHECK(first[0] == "2");
+        CHECK(second[1] == "6");
+      }
+    }
+  }
+  GIVEN("a full rejecting buffer") {
+    my::Dynamic_ring_buffer<int, my::Heap_storage, my::Reject> buffer{3};
+    const std::vector<int> elements{1, 2, 3, 4};
+    CHECK(buffer.push_n(elements) == 3);
+    WHEN("trying to push one more element") {
+      const bool pushed = buffer.try_push(5);
+      THEN("the push is rejected") {
+        CHECK(!pushed);
+        std::array<int, 3> out{};
+        CHECK(buffer.pop_n(out) == 3);
+        CHECK(out == std::array{1, 2, 3});
+      }
+    }
+  }
+}
+SCENARIO("Dynamic ring buffer: mmap storage") {
+  GIVEN("a buffer backed by huge pages, or normal pages if there are none") {
+    my::Dynamic_ring_buffer<std::uint64_t, my::Mmap_storage<true>> buffer{1000};
+    THEN("its capacity fills whole huge pages") {
+      CHECK(buffer.capacity() == my::huge_page_size / sizeof(std::uint64_t));
+    }
+    WHEN("pushing more elements than the capacity") {
+      std::vector<std::uint64_t> elements(buffer.capacity() + 10);
+      std::iota(elements.begin(), elements.end(), 0);
+      buffer.push_n(elements);
+      THEN("the oldest elements are overwritten") {
+        CHECK(buffer.size() == buffer.capacity());
+        CHECK(buffer.pop().value() == 10);
+      }
+    }
+  }
+}
+SCENARIO("Dynamic ring buffer: mirrored storage") {
+  GIVEN("a buffer that fills one page") {
+    my::Dynamic_ring_buffer<std::uint32_t, my::Mirrored_storage<>> buffer{1};
+    const auto capacity = buffer.capacity();
+    CHECK(capacity == my::page_size() / sizeof(std::uint32_t));
+    WHEN("the live region wraps around the end of the buffer") {
+      std::vector<std::uint32_t> elements(capacity);
+      std::iota(elements.begin(), elements.end(), 0);
+      buffer.push_n(elements);
+      CHECK(buffer.discard(capacity - 2) == capacity - 2);
+      const std::vector<std::uint32_t> more{1000, 1001, 1002};
+      CHECK(buffer.push_n(more) == 3);
+      THEN("peek_contiguous() returns it as a single span") {
+        const auto [first, second] = buffer.peek_contiguous();
+        CHECK(second.empty());
+        CHECK(std::vector<std::uint32_t>(first.begin(), first.end())
+          == std::vector<std::uint32_t>{
+            static_cast<std::uint32_t>(capacity - 2),
+            static_cast<std::uint32_t>(capacity - 1),
+            1000, 1001, 1002});
+      }
+      THEN("pop_n() moves it out in order") {
+        std::array<std::uint32_t, 8> out{};
+        CHECK(buffer.pop_n(out) == 5);
+        CHECK(out[1] == capacity - 1);
+        CHECK(out[2] == 1000);
+        CHECK(out[4] == 1002);
+      }
+      THEN("single pops read the elements written through the mirror") {
+        buffer.discard(2);
+        CHECK(buffer.pop().value() == 1000);
+      }
+    }
+  }
+}
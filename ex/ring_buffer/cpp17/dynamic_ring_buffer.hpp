@@ -0,0 +1,395 @@
+/**
+ * @brief Dynamic_ring_buffer is a FIFO container whose capacity is
+ * chosen when it is constructed, and whose elements live in memory
+ * provided by a Storage policy (see ring_storage.hpp).
+ *
+ * It offers the interface of Ring_buffer, including the bulk methods,
+ * for buffers that are too large for the stack or a global: a capture
+ * buffer of 256 MB is `Dynamic_ring_buffer<Sample, Mmap_storage<true>>`
+ * constructed with the number of samples.
+ *
+ * The capacity is rounded up so that the buffer fills whole units of
+ * the storage's granularity, e.g. pages; `capacity()` tells the actual
+ * value, which is never less than the requested one.
+ *
+ * With Mirrored_storage, the memory right after the last slot maps the
+ * first slot again. A range of live elements that wraps around the end
+ * of the buffer is then contiguous in the address space: the bulk
+ * methods do a single copy, and `peek_contiguous()` returns a single
+ * span. Since each element is visible at two addresses, T must be
+ * trivially copyable.
+ *
+ * Only the Overwrite and Reject policies are supported, and the buffer
+ * is not thread-safe.
+ */
+#pragma once
+
+#include "full_policy.hpp"
+#include "ring_storage.hpp"
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+
+/**
+ * FIFO containers with a run-time capacity.
+ *
+ * @tparam T The element stored in the buffer.
+ * @tparam Storage Heap_storage, Mmap_storage or Mirrored_storage.
+ * @tparam Policy Overwrite or Reject.
+ */
+template<typename T, typename Storage = Heap_storage, typename Policy = Overwrite>
+class Dynamic_ring_buffer {
+  static_assert(std::is_same_v<Policy, Overwrite> || std::is_same_v<Policy, Reject>);
+  static_assert(!Storage::mirrored || std::is_trivially_copyable_v<T>,
+    "a mirrored buffer holds each element at two addresses");
+  static_assert(alignof(T) <= Storage::alignment);
+
+public:
+  /**
+   * @param capacity The minimum number of elements in the buffer.
+   */
+  explicit Dynamic_ring_buffer(std::size_t capacity);
+
+  Dynamic_ring_buffer(const Dynamic_ring_buffer&) = delete;
+  Dynamic_ring_buffer& operator=(const Dynamic_ring_buffer&) = delete;
+  ~Dynamic_ring_buffer();
+
+  /**
+   * @return The maximum number of elements in the buffer.
+   */
+  std::size_t capacity() const { return cap; }
+
+  /**
+   * @return The number of elements in the buffer.
+   */
+  std::size_t size() const { return count; }
+
+  /**
+   * Copies the argument into the buffer.
+   *
+   * @param T The element to be copied into the buffer.
+   */
+  void push(const T&) requires std::is_same_v<Policy, Overwrite>;
+
+  /**
+   * Moves the argument into the buffer.
+   *
+   * @param T The element to be moved into the buffer.
+   */
+  void push(T&&) requires std::is_same_v<Policy, Overwrite>;
+
+  /**
+   * Constructs an element from the arguments directly in the buffer.
+   *
+   * @param args The arguments passed to the constructor of T.
+   */
+  template<typename... Args>
+  void emplace(Args&&... args) requires std::is_same_v<Policy, Overwrite>;
+
+  /**
+   * Copies the argument into the buffer unless the buffer is full.
+   *
+   * @param T The element to be copied into the buffer.
+   * @return false if the buffer is full and Policy is Reject, true
+   * otherwise.
+   */
+  bool try_push(const T&);
+
+  /**
+   * Moves the argument into the buffer unless the buffer is full.
+   *
+   * @param T The element to be moved into the buffer.
+   * @return false if the buffer is full and Policy is Reject, true
+   * otherwise.
+   */
+  bool try_push(T&&);
+
+  /**
+   * Constructs an element from the arguments directly in the buffer
+   * unless the buffer is full.
+   *
+   * @param args The arguments passed to the constructor of T.
+   * @return false if the buffer is full and Policy is Reject, true
+   * otherwise.
+   */
+  template<typename... Args>
+  bool try_emplace(Args&&... args);
+
+  /**
+   * Returns the oldest element in the buffer.
+   *
+   * @return The optional value of the oldest element in the
+   * buffer, or `optional.empty`.
+   */
+  std::optional<T> pop();
+
+  /**
+   * Copies the elements of the argument into the buffer, first element
+   * first. With Overwrite, all of them are pushed, and only the last
+   * capacity() survive. With Reject, as many as fit are pushed.
+   *
+   * @param elements The elements to be copied into the buffer.
+   * @return The number of elements pushed.
+   */
+  std::size_t push_n(std::span<const T> elements);
+
+  /**
+   * Moves the oldest elements in the buffer into the argument, oldest
+   * first.
+   *
+   * @param elements The span that receives the elements.
+   * @return The number of elements popped.
+   */
+  std::size_t pop_n(std::span<T> elements);
+
+  /**
+   * Returns the elements in the buffer without removing them, oldest
+   * first, as two spans. With Mirrored_storage the second span is
+   * always empty. The spans are valid until the next push.
+   *
+   * @return The live region as at most two non-empty spans.
+   */
+  std::array<std::span<const T>, 2> peek_contiguous() const;
+
+  /**
+   * Removes at most n oldest elements without returning them.
+   *
+   * @param n The number of elements to be removed.
+   * @return The number of elements removed.
+   */
+  std::size_t discard(std::size_t n);
+
+  private:
+  static std::size_t rounded_capacity(std::size_t capacity);
+  std::size_t advance(std::size_t i, std::size_t n) const;
+  void make_room(std::size_t n);
+  template<typename U>
+  void put(U&& e);
+  void copy_in(std::span<const T> elements);
+
+  /**
+   * With Mirrored_storage, i may go up to 2 * capacity().
+   */
+  T* slot(std::size_t i) const {
+    return std::launder(reinterpret_cast<T*>(storage.data()) + i);
+  }
+
+  std::size_t cap;
+  Storage storage;
+  std::size_t write_idx{0};
+  std::size_t read_idx{0};
+  std::size_t count{0};
+};
+
+template<typename T, typename Storage, typename Policy>
+Dynamic_ring_buffer<T, Storage, Policy>::Dynamic_ring_buffer(std::size_t capacity)
+: cap{rounded_capacity(capacity)}, storage{cap * sizeof(T)} {}
+
+template<typename T, typename Storage, typename Policy>
+Dynamic_ring_buffer<T, Storage, Policy>::~Dynamic_ring_buffer() {
+  discard(count);
+}
+
+template<typename T, typename Storage, typename Policy>
+void Dynamic_ring_buffer<T, Storage, Policy>::push(const T& e)
+requires std::is_same_v<Policy, Overwrite> {
+  put(e);
+}
+
+template<typename T, typename Storage, typename Policy>
+void Dynamic_ring_buffer<T, Storage, Policy>::push(T&& e)
+requires std::is_same_v<Policy, Overwrite> {
+  put(std::move(e));
+}
+
+template<typename T, typename Storage, typename Policy>
+template<typename... Args>
+void Dynamic_ring_buffer<T, Storage, Policy>::emplace(Args&&... args)
+requires std::is_same_v<Policy, Overwrite> {
+  make_room(1);
+  std::construct_at(slot(write_idx), std::forward<Args>(args)...);
+  write_idx = advance(write_idx, 1);
+  count++;
+}
+
+template<typename T, typename Storage, typename Policy>
+bool Dynamic_ring_buffer<T, Storage, Policy>::try_push(const T& e) {
+  if (std::is_same_v<Policy, Reject> && count == cap) {
+    return false;
+  }
+  put(e);
+  return true;
+}
+
+template<typename T, typename Storage, typename Policy>
+bool Dynamic_ring_buffer<T, Storage, Policy>::try_push(T&& e) {
+  if (std::is_same_v<Policy, Reject> && count == cap) {
+    return false;
+  }
+  put(std::move(e));
+  return true;
+}
+
+template<typename T, typename Storage, typename Policy>
+template<typename... Args>
+bool Dynamic_ring_buffer<T, Storage, Policy>::try_emplace(Args&&... args) {
+  if (std::is_same_v<Policy, Reject> && count == cap) {
+    return false;
+  }
+  make_room(1);
+  std::construct_at(slot(write_idx), std::forward<Args>(args)...);
+  write_idx = advance(write_idx, 1);
+  count++;
+  return true;
+}
+
+template<typename T, typename Storage, typename Policy>
+std::optional<T> Dynamic_ring_buffer<T, Storage, Policy>::pop() {
+  if (count == 0) {
+    return {};
+  }
+  // destroys the element after it has been moved into the return
+  // value, which is constructed in place in the caller
+  struct Release {
+    Dynamic_ring_buffer& buffer;
+    ~Release() {
+      std::destroy_at(buffer.slot(buffer.read_idx));
+      buffer.read_idx = buffer.advance(buffer.read_idx, 1);
+      buffer.count--;
+    }
+  } release{*this};
+
+  return std::optional<T>{std::move(*slot(read_idx))};
+}
+
+template<typename T, typename Storage, typename Policy>
+std::size_t Dynamic_ring_buffer<T, Storage, Policy>::push_n(std::span<const T> elements) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    if (elements.size() > cap) {
+      elements = elements.last(cap);
+    }
+    make_room(elements.size());
+  } else {
+    elements = elements.first(std::min(elements.size(), cap - count));
+  }
+  copy_in(elements);
+  write_idx = advance(write_idx, elements.size());
+  count += elements.size();
+  return elements.size();
+}
+
+template<typename T, typename Storage, typename Policy>
+std::size_t Dynamic_ring_buffer<T, Storage, Policy>::pop_n(std::span<T> elements) {
+  const auto n = std::min(elements.size(), count);
+  if constexpr (Storage::mirrored) {
+    std::move(slot(read_idx), slot(read_idx) + n, elements.begin());
+  } else {
+    const auto first = std::min(n, cap - read_idx);
+    auto out = std::move(slot(read_idx), slot(read_idx) + first, elements.begin());
+    std::move(slot(0), slot(0) + (n - first), out);
+  }
+  discard(n);
+  return n;
+}
+
+template<typename T, typename Storage, typename Policy>
+std::array<std::span<const T>, 2> Dynamic_ring_buffer<T, Storage, Policy>::peek_contiguous() const {
+  if constexpr (Storage::mirrored) {
+    return {std::span<const T>{slot(read_idx), count}, std::span<const T>{}};
+  } else {
+    const auto first = std::min(count, cap - read_idx);
+    return {
+      std::span<const T>{slot(read_idx), first},
+      std::span<const T>{slot(0), count - first}
+    };
+  }
+}
+
+template<typename T, typename Storage, typename Policy>
+std::size_t Dynamic_ring_buffer<T, Storage, Policy>::discard(std::size_t n) {
+  n = std::min(n, count);
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    const auto first = std::min(n, cap - read_idx);
+    std::destroy(slot(read_idx), slot(read_idx) + first);
+    std::destroy(slot(0), slot(0) + (n - first));
+  }
+  read_idx = advance(read_idx, n);
+  count -= n;
+  return n;
+}
+
+/**
+ * Rounds the capacity up so that the bytes it takes are a multiple of
+ * both the storage's granularity and sizeof(T).
+ */
+template<typename T, typename Storage, typename Policy>
+std::size_t Dynamic_ring_buffer<T, Storage, Policy>::rounded_capacity(std::size_t capacity) {
+  const auto unit = std::lcm(Storage::granularity(), sizeof(T));
+  const auto bytes = std::max<std::size_t>(capacity, 1) * sizeof(T);
+  return (bytes + unit - 1) / unit * unit / sizeof(T);
+}
+
+/**
+ * Wraps without a division, since the capacity is not a constant.
+ */
+template<typename T, typename Storage, typename Policy>
+std::size_t Dynamic_ring_buffer<T, Storage, Policy>::advance(std::size_t i, std::size_t n) const {
+  i += n;
+  return i >= cap ? i - cap : i;
+}
+
+template<typename T, typename Storage, typename Policy>
+void Dynamic_ring_buffer<T, Storage, Policy>::make_room(std::size_t n) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    if (count + n > cap) {
+      discard(count + n - cap);
+    }
+  }
+}
+
+/**
+ * With Overwrite and a full buffer, the slot to write holds the oldest
+ * element, so it is assigned over.
+ */
+template<typename T, typename Storage, typename Policy>
+template<typename U>
+void Dynamic_ring_buffer<T, Storage, Policy>::put(U&& e) {
+  if constexpr (std::is_same_v<Policy, Overwrite> && std::is_assignable_v<T&, U&&>) {
+    if (count == cap) {
+      *slot(write_idx) = std::forward<U>(e);
+      write_idx = advance(write_idx, 1);
+      read_idx = write_idx;
+      return;
+    }
+  }
+  make_room(1);
+  std::construct_at(slot(write_idx), std::forward<U>(e));
+  write_idx = advance(write_idx, 1);
+  count++;
+}
+
+/**
+ * The slots must be free. With Mirrored_storage, the elements that go
+ * past the last slot land in the first slots through the mirror.
+ */
+template<typename T, typename Storage, typename Policy>
+void Dynamic_ring_buffer<T, Storage, Policy>::copy_in(std::span<const T> elements) {
+  if constexpr (Storage::mirrored) {
+    std::uninitialized_copy(elements.begin(), elements.end(), slot(write_idx));
+  } else {
+    const auto first = std::min(elements.size(), cap - write_idx);
+    std::uninitialized_copy(elements.begin(), elements.begin() + first, slot(write_idx));
+    std::uninitialized_copy(elements.begin() + first, elements.end(), slot(0));
+  }
+}
+
+}
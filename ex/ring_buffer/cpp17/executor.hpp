@@ -0,0 +1,101 @@
+/**
+ * @brief A minimal single-threaded executor for C++20 coroutines, used
+ * to drive Channel in tests and examples.
+ *
+ * A Task is a coroutine that starts suspended. `Executor::spawn()`
+ * queues it, and `Executor::run()` resumes queued coroutines one after
+ * another on the calling thread until the queue is empty. A coroutine
+ * that suspends on something else, such as a Channel, is resumed by
+ * whoever completes that thing, not by the executor.
+ *
+ * The executor owns the frames of the tasks it has spawned and
+ * destroys them in its destructor, whether they have finished or not.
+ *
+ * sample usage:
+ *     my::Executor executor;
+ *     executor.spawn([]() -> my::Task { co_return; }());
+ *     executor.run();
+ */
+#pragma once
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace my {
+
+class Task {
+public:
+  struct promise_type {
+    Task get_return_object() {
+      return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    // keeps the frame alive until the executor destroys it
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Task(Task&& other) noexcept : handle{std::exchange(other.handle, nullptr)} {}
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  /**
+   * @return true if the coroutine has run to its end.
+   */
+  bool done() const { return handle.done(); }
+
+private:
+  friend class Executor;
+  explicit Task(std::coroutine_handle<promise_type> h) : handle{h} {}
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+class Executor {
+public:
+  /**
+   * Queues the task, which has not started yet, and takes it over.
+   */
+  void spawn(Task task) {
+    queue.push_back(task.handle);
+    tasks.push_back(std::move(task));
+  }
+
+  /**
+   * Resumes queued coroutines until the queue is empty.
+   */
+  void run() {
+    while (!queue.empty()) {
+      auto handle = queue.front();
+      queue.pop_front();
+      handle.resume();
+    }
+  }
+
+  /**
+   * @return true if every spawned task has run to its end.
+   */
+  bool all_done() const {
+    for (const auto& task : tasks) {
+      if (!task.done()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  std::deque<std::coroutine_handle<>> queue;
+  std::vector<Task> tasks;
+};
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * @brief Full-buffer policies tell a bounded FIFO container what to do
+ * when an element is pushed into a buffer that is already full.
+ *
+ * The policies are empty tag types passed as a template argument, so
+ * the choice is made at compile time and costs nothing at run time.
+ */
+
+namespace my {
+
+/**
+ * Overwrites the oldest element with the new one. Useful for telemetry
+ * where the latest samples matter most.
+ */
+struct Overwrite {};
+
+/**
+ * Leaves the buffer untouched and reports the failure to the caller.
+ * Useful for command queues where no work may be silently dropped.
+ */
+struct Reject {};
+
+/**
+ * Parks the pushing thread until a consumer makes room, and parks the
+ * popping thread until a producer supplies an element. The threads
+ * sleep in `std::atomic::wait()` rather than spinning.
+ */
+struct Block {};
+
+}
@@ -0,0 +1,169 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "mpmc_queue.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+SCENARIO("MPMC queue: normal cases") {
+  GIVEN("empty queue") {
+    my::Mpmc_queue<int, 3> queue{};
+    WHEN("trying to get the element") {
+      auto element = queue.try_pop();
+      THEN("its value should be empty") {
+        CHECK(!element);
+      }
+    }
+  }
+  GIVEN("N elements in the rejecting queue") {
+    my::Mpmc_queue<int, 3, my::Reject> queue{};
+    CHECK(queue.try_push(1));
+    CHECK(queue.try_push(2));
+    CHECK(queue.try_push(3));
+    WHEN("pushing the N+1th element") {
+      const bool pushed = queue.try_push(4);
+      THEN("the push is rejected and the elements are kept") {
+        CHECK(!pushed);
+        CHECK(queue.try_pop().value() == 1);
+        CHECK(queue.try_pop().value() == 2);
+        CHECK(queue.try_pop().value() == 3);
+        CHECK(!queue.try_pop());
+      }
+    }
+  }
+  GIVEN("N elements in the overwriting queue") {
+    my::Mpmc_queue<int, 3, my::Overwrite> queue{};
+    CHECK(queue.try_push(1));
+    CHECK(queue.try_push(2));
+    CHECK(queue.try_push(3));
+    WHEN("pushing the N+1th and N+2th element") {
+      CHECK(queue.try_push(4));
+      CHECK(queue.try_push(5));
+      THEN("the two oldest elements are overwritten") {
+        CHECK(queue.try_pop().value() == 3);
+        CHECK(queue.try_pop().value() == 4);
+        CHECK(queue.try_pop().value() == 5);
+        CHECK(!queue.try_pop());
+      }
+    }
+  }
+}
+SCENARIO("MPMC queue: many producer and consumer threads") {
+  GIVEN("a small queue shared by four producers and four consumers") {
+    constexpr std::size_t threads = 4;
+    constexpr std::size_t count = 200'000;
+    my::Mpmc_queue<std::size_t, 64> queue{};
+    WHEN("each producer pushes its own ascending numbers") {
+      // element = producer * count + i
+      std::vector<std::vector<std::size_t>> received(threads);
+      std::atomic<std::size_t> remaining{threads * count};
+      std::vector<std::thread> workers;
+      for (std::size_t p = 0; p < threads; p++) {
+        workers.emplace_back([&queue, p] {
+          for (std::size_t i = 0; i < count; i++) {
+            while (!queue.try_push(p * count + i)) {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+      for (std::size_t c = 0; c < threads; c++) {
+        workers.emplace_back([&queue, &remaining, &mine = received[c]] {
+          while (remaining.load(std::memory_order_relaxed) > 0) {
+            if (auto element = queue.try_pop()) {
+              mine.push_back(element.value());
+              remaining.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+              std::this_thread::yield();
+            }
+          }
+        });
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+      THEN("every element is received exactly once") {
+        std::vector<int> seen(threads * count);
+        for (const auto& mine : received) {
+          for (auto e : mine) {
+            seen[e]++;
+          }
+        }
+        bool exactly_once = true;
+        for (auto s : seen) {
+          exactly_once = exactly_once && s == 1;
+        }
+        CHECK(exactly_once);
+      }
+      THEN("each consumer sees each producer's elements in order") {
+        bool in_order = true;
+        for (const auto& mine : received) {
+          std::array<std::size_t, threads> last{};
+          std::array<bool, threads> any{};
+          for (auto e : mine) {
+            const auto p = e / count;
+            in_order = in_order && (!any[p] || last[p] < e);
+            last[p] = e;
+            any[p] = true;
+          }
+        }
+        CHECK(in_order);
+      }
+    }
+  }
+}
+namespace {
+
+// an element whose move construction, as in try_pop(), waits while the
+// test holds the consumer that moves it
+struct Gated {
+  static inline std::atomic<bool> hold{false};
+  static inline std::atomic<bool> entered{false};
+
+  int value{0};
+
+  Gated() = default;
+  Gated(int v) : value{v} {}
+  Gated(Gated&& other) : value{other.value} {
+    if (hold.load()) {
+      entered.store(true);
+      while (hold.load()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  Gated& operator=(Gated&&) = default;
+};
+
+}
+
+SCENARIO("MPMC queue: overwriting while a consumer is in flight") {
+  GIVEN("a full overwriting queue") {
+    my::Mpmc_queue<Gated, 2, my::Overwrite> queue{};
+    queue.try_push(Gated{1});
+    queue.try_push(Gated{2});
+    WHEN("pushing while a consumer has claimed the oldest element but not freed its slot") {
+      Gated::hold.store(true);
+      int popped = 0;
+      std::thread consumer{[&queue, &popped] { popped = queue.try_pop()->value; }};
+      while (!Gated::entered.load()) {
+        std::this_thread::yield();
+      }
+      std::thread producer{[&queue] { queue.try_push(Gated{3}); }};
+      // let the producer find the slot taken
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      Gated::hold.store(false);
+      consumer.join();
+      producer.join();
+      THEN("the push waits for the slot and discards nothing") {
+        CHECK(popped == 1);
+        CHECK(queue.try_pop()->value == 2);
+        CHECK(queue.try_pop()->value == 3);
+        CHECK(!queue.try_pop());
+      }
+    }
+  }
+}
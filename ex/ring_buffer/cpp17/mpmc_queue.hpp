@@ -0,0 +1,199 @@
+/**
+ * @brief Mpmc_queue is a bounded FIFO container that can store at most
+ * N elements of type T, shared by any number of producer threads and
+ * consumer threads without a lock.
+ *
+ * Like Ring_buffer, Mpmc_queue stores its elements directly within the
+ * object itself, so it allocates nothing.
+ *
+ * The algorithm is Dmitry Vyukov's bounded MPMC queue. Every slot has
+ * a sequence number next to the element. A producer that has claimed
+ * position `pos` may write the slot only when its sequence equals
+ * `pos`, and publishes the element by storing `pos + 1`. A consumer
+ * that has claimed `pos` may read the slot only when its sequence
+ * equals `pos + 1`, and frees it for the next lap by storing `pos + N`.
+ * Producers claim positions with a CAS on `enqueue_pos`, consumers on
+ * `dequeue_pos`; they never touch each other's counter.
+ *
+ * The `try_push()` method copies/moves the argument into the buffer.
+ * What happens if the buffer is full depends on the Policy:
+ * - Reject: the method returns false and the buffer is left untouched.
+ * - Overwrite: the method pops and discards the oldest element, then
+ *   retries, like `Ring_buffer::push()`. It always returns true. A
+ *   push finds its slot still taken also while a consumer is reading
+ *   the element there; it then retries without discarding anything,
+ *   so a push discards at most one element.
+ *
+ * The `try_pop()` method may return the oldest element in the buffer.
+ * If the buffer is empty, `optional.empty` is returned.
+ */
+#pragma once
+
+#include "full_policy.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <array>
+#include <type_traits>
+
+namespace my {
+
+/**
+ * Lock-free bounded FIFO containers for many producers and consumers.
+ *
+ * @tparam T The element stored in a built-in buffer.
+ * @tparam N The maximum number of elements in the buffer.
+ * @tparam Policy Either Reject or Overwrite.
+ */
+template<typename T, std::size_t N, typename Policy = Reject>
+class Mpmc_queue {
+  static_assert(std::is_same_v<Policy, Reject> || std::is_same_v<Policy, Overwrite>);
+
+public:
+  Mpmc_queue();
+
+  Mpmc_queue(const Mpmc_queue&) = delete;
+  Mpmc_queue& operator=(const Mpmc_queue&) = delete;
+
+  /**
+   * Copies the argument into a buffer built in the instance.
+   *
+   * @param T The element to be copied into the buffer.
+   * @return false if the buffer is full and Policy is Reject,
+   * true otherwise.
+   */
+  bool try_push(const T&);
+
+  /**
+   * Moves the argument into a buffer built in the instance.
+   *
+   * @param T The element to be moved into the buffer.
+   * @return false if the buffer is full and Policy is Reject,
+   * true otherwise.
+   */
+  bool try_push(T&&);
+
+  /**
+   * Returns the oldest element in the buffer.
+   *
+   * @return The optional value of the oldest element in the
+   * buffer, or `optional.empty`.
+   */
+  std::optional<T> try_pop();
+
+  private:
+  template<typename U>
+  bool enqueue(U&&);
+
+  void make_room();
+
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    T value{};
+  };
+
+  std::array<Slot, N> buffer{};
+  std::atomic<std::size_t> enqueue_pos{0};
+  std::atomic<std::size_t> dequeue_pos{0};
+};
+
+template<typename T, std::size_t N, typename Policy>
+Mpmc_queue<T, N, Policy>::Mpmc_queue() {
+  for (std::size_t i = 0; i < N; i++) {
+    buffer[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template<typename T, std::size_t N, typename Policy>
+bool Mpmc_queue<T, N, Policy>::try_push(const T& e) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    while (!enqueue(e)) {
+      make_room();
+    }
+    return true;
+  } else {
+    return enqueue(e);
+  }
+}
+
+template<typename T, std::size_t N, typename Policy>
+bool Mpmc_queue<T, N, Policy>::try_push(T&& e) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    // enqueue() moves from e only when it succeeds
+    while (!enqueue(std::move(e))) {
+      make_room();
+    }
+    return true;
+  } else {
+    return enqueue(std::move(e));
+  }
+}
+
+template<typename T, std::size_t N, typename Policy>
+template<typename U>
+bool Mpmc_queue<T, N, Policy>::enqueue(U&& e) {
+  auto pos = enqueue_pos.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &buffer[pos % N];
+    const auto seq = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the slot still holds the element from the previous lap
+      return false;
+    } else {
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  slot->value = std::forward<U>(e);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+/**
+ * Discards the oldest element if the buffer is full. enqueue() also
+ * fails when a consumer has claimed the slot but not freed it yet; the
+ * buffer is not full then, and nothing is discarded.
+ */
+template<typename T, std::size_t N, typename Policy>
+void Mpmc_queue<T, N, Policy>::make_room() {
+  // dequeue_pos is read last, so the difference is at most the number
+  // of elements when enqueue_pos was read; it may be negative
+  const auto enqueued = enqueue_pos.load(std::memory_order_acquire);
+  const auto dequeued = dequeue_pos.load(std::memory_order_acquire);
+  if (static_cast<std::intptr_t>(enqueued - dequeued) >= static_cast<std::intptr_t>(N)) {
+    try_pop();
+  }
+}
+
+template<typename T, std::size_t N, typename Policy>
+std::optional<T> Mpmc_queue<T, N, Policy>::try_pop() {
+  auto pos = dequeue_pos.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &buffer[pos % N];
+    const auto seq = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // no producer has published this position yet
+      return {};
+    } else {
+      pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+  std::optional<T> element{std::move(slot->value)};
+  slot->sequence.store(pos + N, std::memory_order_release);
+
+  return element;
+}
+
+}
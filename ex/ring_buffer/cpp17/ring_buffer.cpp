@@ -1,8 +1,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "ring_buffer.hpp"
+#include <tracked.hpp>
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 SCENARIO("Ring buffer: use cases") {
   GIVEN("three-element buffer") {}
@@ -28,6 +37,10 @@ SCENARIO("Ring buffer: use cases") {
         const int result = std::accumulate(std::begin(numbers), std::end(numbers), 0);
         CHECK(result == 12);
       }
+      THEN("you can sum the elements without popping them") {
+        CHECK(std::accumulate(buffer.begin(), buffer.end(), 0) == 12);
+        CHECK(buffer.size() == 3);
+      }
     }
 }
 SCENARIO("Ring buffer: normal cases") {
@@ -132,3 +145,634 @@ SCENARIO("Ring buffer: normal cases") {
     }
   }
 }
+SCENARIO("Ring buffer: full-buffer policies") {
+  GIVEN("N elements in the overwriting buffer") {
+    my::Ring_buffer<int, 3, my::Overwrite> buffer{};
+    buffer.push(1);
+    buffer.push(2);
+    buffer.push(3);
+    WHEN("trying to push the N+1th element") {
+      const bool pushed = buffer.try_push(4);
+      THEN("the oldest element is overwritten") {
+        CHECK(pushed);
+        CHECK(buffer.pop().value() == 2);
+        CHECK(buffer.pop().value() == 3);
+        CHECK(buffer.pop().value() == 4);
+        CHECK(!buffer.pop());
+      }
+    }
+  }
+  GIVEN("N elements in the rejecting buffer") {
+    my::Ring_buffer<int, 3, my::Reject> buffer{};
+    CHECK(buffer.try_push(1));
+    CHECK(buffer.try_push(2));
+    CHECK(buffer.try_push(3));
+    WHEN("trying to push the N+1th element") {
+      const bool pushed = buffer.try_push(4);
+      THEN("the push is rejected and the elements are kept") {
+        CHECK(!pushed);
+        CHECK(buffer.pop().value() == 1);
+        CHECK(buffer.pop().value() == 2);
+        CHECK(buffer.pop().value() == 3);
+        CHECK(!buffer.pop());
+      }
+    }
+    WHEN("popping one element") {
+      buffer.pop();
+      THEN("there is room for one more") {
+        CHECK(buffer.try_push(4));
+        CHECK(!buffer.try_push(5));
+      }
+    }
+  }
+  GIVEN("N elements in the blocking buffer") {
+    my::Ring_buffer<int, 3, my::Block> buffer{};
+    buffer.push(1);
+    buffer.push(2);
+    buffer.push(3);
+    WHEN("trying to push the N+1th element") {
+      const bool pushed = buffer.try_push(4);
+      THEN("the push is rejected without waiting") {
+        CHECK(!pushed);
+      }
+    }
+  }
+  GIVEN("a blocking buffer shared by a producer and a consumer thread") {
+    constexpr int count = 100'000;
+    my::Ring_buffer<int, 3, my::Block> buffer{};
+    WHEN("the producer pushes more elements than the buffer holds") {
+      std::thread producer{[&buffer] {
+        for (int i = 0; i < count; i++) {
+          buffer.push(i);
+        }
+      }};
+      bool in_order = true;
+      for (int i = 0; i < count; i++) {
+        in_order = in_order && buffer.pop().value() == i;
+      }
+      producer.join();
+      THEN("the consumer gets every element in order") {
+        CHECK(in_order);
+      }
+    }
+  }
+}
+SCENARIO("Ring buffer: bulk operations") {
+  GIVEN("a five-element buffer that has wrapped around") {
+    my::Ring_buffer<int, 5> buffer{};
+    for (int i = 0; i < 7; i++) {
+      buffer.push(i);
+    }
+    WHEN("peeking at the live region") {
+      const auto [first, second] = buffer.peek_contiguous();
+      THEN("you get the elements oldest first in two spans") {
+        CHECK(first.size() == 3);
+        CHECK(second.size() == 2);
+        CHECK(std::vector<int>(first.begin(), first.end()) == std::vector{2, 3, 4});
+        CHECK(std::vector<int>(second.begin(), second.end()) == std::vector{5, 6});
+      }
+      THEN("nothing is removed") {
+        CHECK(buffer.pop().value() == 2);
+      }
+    }
+    WHEN("discarding two elements") {
+      CHECK(buffer.discard(2) == 2);
+      THEN("the live region starts at the third oldest element") {
+        const auto [first, second] = buffer.peek_contiguous();
+        CHECK(first.size() == 1);
+        CHECK(first[0] == 4);
+        CHECK(second.size() == 2);
+      }
+    }
+    WHEN("popping into a span larger than the buffer") {
+      std::array<int, 8> out{};
+      const auto n = buffer.pop_n(out);
+      THEN("you get every element in order across the wrap-around") {
+        CHECK(n == 5);
+        CHECK(std::vector<int>(out.begin(), out.begin() + n) == std::vector{2, 3, 4, 5, 6});
+        CHECK(!buffer.pop());
+      }
+    }
+    WHEN("popping into a span smaller than the buffer") {
+      std::array<int, 2> out{};
+      const auto n = buffer.pop_n(out);
+      THEN("you get the oldest elements only") {
+        CHECK(n == 2);
+        CHECK(out == std::array{2, 3});
+        CHECK(buffer.pop().value() == 4);
+      }
+    }
+  }
+  GIVEN("an overwriting buffer with two elements") {
+    my::Ring_buffer<int, 5> buffer{};
+    buffer.push(1);
+    buffer.push(2);
+    WHEN("pushing a span that overflows the buffer") {
+      const std::vector<int> elements{3, 4, 5, 6, 7};
+      CHECK(buffer.push_n(elements) == 5);
+      THEN("the oldest elements are overwritten") {
+        std::array<int, 5> out{};
+        CHECK(buffer.pop_n(out) == 5);
+        CHECK(out == std::array{3, 4, 5, 6, 7});
+      }
+    }
+    WHEN("pushing a span longer than the buffer") {
+      const std::vector<int> elements{10, 11, 12, 13, 14, 15, 16};
+      CHECK(buffer.push_n(elements) == 5);
+      THEN("only the last N elements survive") {
+        std::array<int, 5> out{};
+        CHECK(buffer.pop_n(out) == 5);
+        CHECK(out == std::array{12, 13, 14, 15, 16});
+      }
+    }
+  }
+  GIVEN("a rejecting buffer with two elements") {
+    my::Ring_buffer<int, 5, my::Reject> buffer{};
+    CHECK(buffer.try_push(1));
+    CHECK(buffer.try_push(2));
+    WHEN("pushing a span that overflows the buffer") {
+      const std::vector<int> elements{3, 4, 5, 6, 7};
+      const auto n = buffer.push_n(elements);
+      THEN("only the elements that fit are pushed") {
+        CHECK(n == 3);
+        std::array<int, 5> out{};
+        CHECK(buffer.pop_n(out) == 5);
+        CHECK(out == std::array{1, 2, 3, 4, 5});
+      }
+    }
+  }
+  GIVEN("a blocking buffer shared by a producer and a consumer thread") {
+    constexpr int count = 100'000;
+    my::Ring_buffer<int, 7, my::Block> buffer{};
+    WHEN("both threads transfer elements in bulk") {
+      std::thread producer{[&buffer] {
+        std::array<int, 5> chunk{};
+        for (int i = 0; i < count; i += chunk.size()) {
+          std::iota(chunk.begin(), chunk.end(), i);
+          buffer.push_n(chunk);
+        }
+      }};
+      bool in_order = true;
+      std::array<int, 3> out{};
+      for (int i = 0; i < count;) {
+        const auto n = buffer.pop_n(out);
+        for (std::size_t j = 0; j < n; j++, i++) {
+          in_order = in_order && out[j] == i;
+        }
+      }
+      producer.join();
+      THEN("the consumer gets every element in order") {
+        CHECK(in_order);
+      }
+    }
+  }
+}
+SCENARIO("Ring buffer: power-of-two capacity") {
+  GIVEN("a four-element buffer") {
+    my::Ring_buffer<int, 4> buffer{};
+    WHEN("pushing 1, 2, ..., 10") {
+      for (int i = 1; i <= 10; i++) {
+        buffer.push(i);
+      }
+      THEN("you get the last four elements in order") {
+        CHECK(buffer.pop().value() == 7);
+        CHECK(buffer.pop().value() == 8);
+        CHECK(buffer.pop().value() == 9);
+        CHECK(buffer.pop().value() == 10);
+        CHECK(!buffer.pop());
+      }
+      THEN("the live region wraps around") {
+        const auto [first, second] = buffer.peek_contiguous();
+        CHECK(std::vector<int>(first.begin(), first.end()) == std::vector{7, 8});
+        CHECK(std::vector<int>(second.begin(), second.end()) == std::vector{9, 10});
+      }
+    }
+    WHEN("pushing a span longer than the buffer") {
+      const std::vector<int> elements{1, 2, 3, 4, 5, 6};
+      buffer.push(0);
+      buffer.push_n(elements);
+      THEN("only the last N elements survive") {
+        std::array<int, 4> out{};
+        CHECK(buffer.pop_n(out) == 4);
+        CHECK(out == std::array{3, 4, 5, 6});
+      }
+    }
+  }
+  GIVEN("a four-element rejecting buffer") {
+    my::Ring_buffer<int, 4, my::Reject> buffer{};
+    for (int i = 1; i <= 4; i++) {
+      CHECK(buffer.try_push(i));
+    }
+    WHEN("trying to push the N+1th element") {
+      const bool pushed = buffer.try_push(5);
+      THEN("the push is rejected") {
+        CHECK(!pushed);
+        CHECK(buffer.pop().value() == 1);
+      }
+    }
+  }
+  GIVEN("a four-element blocking buffer shared by a producer and a consumer thread") {
+    constexpr int count = 100'000;
+    my::Ring_buffer<int, 4, my::Block> buffer{};
+    WHEN("the producer pushes more elements than the buffer holds") {
+      std::thread producer{[&buffer] {
+        for (int i = 0; i < count; i++) {
+          buffer.push(i);
+        }
+      }};
+      bool in_order = true;
+      for (int i = 0; i < count; i++) {
+        in_order = in_order && buffer.pop().value() == i;
+      }
+      producer.join();
+      THEN("the consumer gets every element in order") {
+        CHECK(in_order);
+      }
+    }
+  }
+}
+namespace {
+
+// counts the special member functions called on any instance
+template <typename T>
+struct Lifetime {
+  static inline int copy_constructed = 0;
+  static inline int copy_assigned = 0;
+  static inline int move_constructed = 0;
+  static inline int move_assigned = 0;
+  static void reset() {
+    copy_constructed = copy_assigned = move_constructed = move_assigned = 0;
+  }
+
+  T content;
+  // value constructor
+  Lifetime(const T& value) : content{value} {}
+  // copy constructor
+  Lifetime(const Lifetime& other) : content{other.content} {
+    copy_constructed++;
+  }
+  // copy assignment
+  Lifetime& operator=(const Lifetime& other) {
+    content = other.content;
+    copy_assigned++;
+    return *this;
+  }
+  // move constructor
+  Lifetime(Lifetime &&other) : content{std::move(other.content)} {
+    move_constructed++;
+  }
+  // move assignment
+  Lifetime& operator=(Lifetime &&other) {
+    content = std::move(other.content);
+    move_assigned++;
+    return *this;
+  }
+};
+
+// counts live instances; has no default constructor
+struct Heavy {
+  static inline int live = 0;
+  std::string name;
+  std::vector<int> values;
+  Heavy(std::string n, std::vector<int> v) : name{std::move(n)}, values{std::move(v)} { live++; }
+  Heavy(const Heavy& other) : name{other.name}, values{other.values} { live++; }
+  Heavy(Heavy&& other) : name{std::move(other.name)}, values{std::move(other.values)} { live++; }
+  Heavy& operator=(const Heavy&) = default;
+  Heavy& operator=(Heavy&&) = default;
+  ~Heavy() { live--; }
+};
+
+// throws on a copy once copies_left copies have been made
+struct Fragile {
+  static inline int copies_left = 0;
+  int value;
+  Fragile(int v) : value{v} {}
+  Fragile(const Fragile& other) : value{other.value} {
+    if (copies_left-- == 0) {
+      throw std::runtime_error{"copy failed"};
+    }
+  }
+  Fragile(Fragile&&) = default;
+  Fragile& operator=(const Fragile&) = default;
+  Fragile& operator=(Fragile&&) = default;
+};
+
+}
+SCENARIO("Ring buffer: uninitialized storage") {
+  GIVEN("an empty buffer of a type with no default constructor") {
+    Heavy::live = 0;
+    {
+      my::Ring_buffer<Heavy, 4096> buffer{};
+      THEN("no element is constructed") {
+        CHECK(Heavy::live == 0);
+      }
+      WHEN("emplacing two elements") {
+        buffer.emplace("first", std::vector{1, 2});
+        buffer.emplace("second", std::vector{3});
+        THEN("exactly two elements are alive") {
+          CHECK(Heavy::live == 2);
+        }
+        THEN("they are constructed from the arguments") {
+          auto element = buffer.pop();
+          CHECK(element.value().name == "first");
+          CHECK(element.value().values == std::vector{1, 2});
+        }
+        THEN("popping destroys the element in the buffer") {
+          {
+            auto element = buffer.pop();
+            CHECK(Heavy::live == 2);
+          }
+          CHECK(Heavy::live == 1);
+        }
+      }
+    }
+    THEN("destroying the buffer destroys the remaining elements") {
+      CHECK(Heavy::live == 0);
+    }
+  }
+  GIVEN("a full overwriting buffer") {
+    Heavy::live = 0;
+    {
+      my::Ring_buffer<Heavy, 3> buffer{};
+      for (int i = 0; i < 3; i++) {
+        buffer.emplace(std::to_string(i), std::vector{i});
+      }
+      WHEN("emplacing one more element") {
+        buffer.emplace("3", std::vector{3});
+        THEN("the oldest element is destroyed") {
+          CHECK(Heavy::live == 3);
+          CHECK(buffer.pop().value().name == "1");
+        }
+      }
+      WHEN("copying the buffer") {
+        my::Ring_buffer<Heavy, 3> copy{buffer};
+        THEN("both buffers hold the elements") {
+          CHECK(Heavy::live == 6);
+          CHECK(copy.pop().value().name == "0");
+          CHECK(buffer.pop().value().name == "0");
+        }
+      }
+    }
+    THEN("destroying the buffer destroys the remaining elements") {
+      CHECK(Heavy::live == 0);
+    }
+  }
+  GIVEN("a full rejecting buffer") {
+    my::Ring_buffer<Heavy, 2, my::Reject> buffer{};
+    CHECK(buffer.try_emplace("a", std::vector<int>{}));
+    CHECK(buffer.try_emplace("b", std::vector<int>{}));
+    WHEN("trying to emplace one more element") {
+      const bool pushed = buffer.try_emplace("c", std::vector<int>{});
+      THEN("the element is not constructed") {
+        CHECK(!pushed);
+        CHECK(buffer.pop().value().name == "a");
+      }
+    }
+  }
+  GIVEN("a full buffer of a type whose copy may throw") {
+    using Item = my::Tracked<Fragile>;
+    using Buffer = my::Ring_buffer<Item, 3>;
+    Buffer buffer{};
+    for (int i = 0; i < 3; i++) {
+      buffer.emplace(i);
+    }
+    WHEN("the copy of the second element throws") {
+      Item::Scope scope;
+      Fragile::copies_left = 1;
+      CHECK_THROWS(Buffer{buffer});
+      THEN("the element copied before it is destroyed") {
+        CHECK(scope.diff().copy_constructed == 1);
+        CHECK(scope.diff().live() == 0);
+      }
+      THEN("the original buffer is untouched") {
+        CHECK(buffer.pop().value().value.value == 0);
+      }
+    }
+  }
+}
+SCENARIO("Ring buffer: copies and moves per element") {
+  using Life = Lifetime<std::string>;
+  GIVEN("an empty buffer") {
+    my::Ring_buffer<Life, 3> buffer{};
+    Life life{"a long string that does not fit in the small buffer"};
+    Life::reset();
+    WHEN("pushing an rvalue") {
+      buffer.push(std::move(life));
+      THEN("the element is moved exactly once") {
+        CHECK(Life::move_constructed == 1);
+        CHECK(Life::move_assigned == 0);
+        CHECK(Life::copy_constructed == 0);
+        CHECK(Life::copy_assigned == 0);
+      }
+      THEN("the caller does not get a stale element back") {
+        CHECK(life.content.empty());
+      }
+      AND_WHEN("popping it") {
+        Life::reset();
+        auto element = buffer.pop();
+        THEN("the element is moved exactly once") {
+          CHECK(Life::move_constructed == 1);
+          CHECK(Life::move_assigned == 0);
+          CHECK(Life::copy_constructed == 0);
+          CHECK(Life::copy_assigned == 0);
+        }
+      }
+    }
+    WHEN("pushing an lvalue") {
+      buffer.push(life);
+      THEN("the element is copied exactly once") {
+        CHECK(Life::copy_constructed == 1);
+        CHECK(Life::move_constructed == 0);
+      }
+    }
+  }
+  GIVEN("a full overwriting buffer") {
+    my::Ring_buffer<Life, 3> buffer{};
+    for (int i = 0; i < 3; i++) {
+      buffer.emplace(std::to_string(i));
+    }
+    Life life{"3"};
+    Life::reset();
+    WHEN("pushing an rvalue") {
+      buffer.push(std::move(life));
+      THEN("the element is move-assigned over the oldest one") {
+        CHECK(Life::move_assigned == 1);
+        CHECK(Life::move_constructed == 0);
+        CHECK(Life::copy_constructed == 0);
+        CHECK(Life::copy_assigned == 0);
+      }
+      THEN("the oldest element is gone") {
+        CHECK(buffer.pop().value().content == "1");
+      }
+    }
+  }
+}
+SCENARIO("Ring buffer: statistics") {
+  // No_stats takes no space
+  static_assert(sizeof(my::Ring_buffer<int, 4>) == 4 * sizeof(int) + 2 * sizeof(std::size_t));
+  static_assert(sizeof(my::Ring_buffer<int, 4, my::Reject>) == 4 * sizeof(int) + 2 * sizeof(std::size_t));
+
+  GIVEN("an overwriting buffer that counts") {
+    my::Ring_buffer<int, 3, my::Overwrite, my::Ring_stats> buffer{};
+    for (int i = 0; i < 5; i++) {
+      buffer.push(i);
+    }
+    WHEN("popping more elements than there are") {
+      for (int i = 0; i < 4; i++) {
+        buffer.pop();
+      }
+      THEN("every push, pop and overwrite is counted") {
+        const auto stats = buffer.stats();
+        CHECK(stats.pushes == 5);
+        CHECK(stats.overwrites == 2);
+        CHECK(stats.pops == 3);
+        CHECK(stats.empty_pops == 1);
+        CHECK(stats.rejected_pushes == 0);
+        CHECK(stats.high_water_mark == 3);
+      }
+    }
+    WHEN("pushing more elements in bulk than there is room for") {
+      const std::array<int, 2> elements{5, 6};
+      buffer.push_n(elements);
+      THEN("the elements pushed over the oldest ones are counted as overwrites") {
+        CHECK(buffer.stats().pushes == 7);
+        CHECK(buffer.stats().overwrites == 4);
+      }
+    }
+  }
+  GIVEN("a rejecting buffer that counts, with two elements") {
+    my::Ring_buffer<int, 4, my::Reject, my::Ring_stats> buffer{};
+    buffer.try_push(1);
+    buffer.try_push(2);
+    WHEN("pushing more elements than there is room for") {
+      const std::array<int, 3> elements{3, 4, 5};
+      buffer.push_n(elements);
+      buffer.try_push(6);
+      THEN("the rejected elements are counted") {
+        const auto stats = buffer.stats();
+        CHECK(stats.pushes == 4);
+        CHECK(stats.rejected_pushes == 2);
+        CHECK(stats.high_water_mark == 4);
+      }
+    }
+    WHEN("popping and discarding the elements") {
+      std::array<int, 1> out{};
+      buffer.pop_n(out);
+      buffer.discard(1);
+      buffer.pop_n(out);
+      THEN("both count as pops") {
+        const auto stats = buffer.stats();
+        CHECK(stats.pops == 2);
+        CHECK(stats.empty_pops == 1);
+        CHECK(stats.high_water_mark == 2);
+      }
+    }
+  }
+  GIVEN("a blocking buffer that counts, shared by a producer and a consumer thread") {
+    constexpr int count = 100'000;
+    my::Ring_buffer<int, 4, my::Block, my::Ring_stats> buffer{};
+    WHEN("the producer pushes more elements than the buffer holds") {
+      std::thread producer{[&buffer] {
+        for (int i = 0; i < count; i++) {
+          buffer.push(i);
+        }
+      }};
+      for (int i = 0; i < count; i++) {
+        buffer.pop();
+      }
+      producer.join();
+      THEN("every element is counted once on each side") {
+        const auto stats = buffer.stats();
+        CHECK(stats.pushes == count);
+        CHECK(stats.pops == count);
+        CHECK(stats.high_water_mark <= 4);
+      }
+    }
+  }
+}
+SCENARIO("Ring buffer: iteration") {
+  using Buffer = my::Ring_buffer<int, 5>;
+  static_assert(std::random_access_iterator<Buffer::iterator>);
+  static_assert(std::random_access_iterator<Buffer::const_iterator>);
+  static_assert(std::ranges::random_access_range<Buffer>);
+  static_assert(std::ranges::sized_range<Buffer>);
+  static_assert(std::ranges::view<decltype(std::declval<const Buffer&>().view())>);
+
+  GIVEN("a five-element buffer that has wrapped around") {
+    Buffer buffer{};
+    for (int i = 1; i <= 7; i++) {
+      buffer.push(i);
+    }
+    WHEN("iterating over it") {
+      const std::vector<int> elements(buffer.begin(), buffer.end());
+      THEN("the elements come oldest first and stay in the buffer") {
+        CHECK(elements == std::vector<int>{3, 4, 5, 6, 7});
+        CHECK(buffer.size() == 5);
+        CHECK(buffer.pop().value() == 3);
+      }
+    }
+    WHEN("indexing the iterators") {
+      const auto first = buffer.begin();
+      THEN("they wrap around the end of the storage") {
+        CHECK(first[0] == 3);
+        CHECK(first[4] == 7);
+        CHECK(*(buffer.end() - 1) == 7);
+        CHECK(buffer.end() - first == 5);
+        CHECK(first < buffer.end());
+      }
+    }
+    WHEN("running range algorithms over the view") {
+      const auto view = buffer.view();
+      THEN("they see the elements in order") {
+        CHECK(std::ranges::max(view) == 7);
+        CHECK(std::ranges::is_sorted(view));
+        CHECK(*std::ranges::find(view, 6) == 6);
+        CHECK((view | std::views::reverse).front() == 7);
+        CHECK(std::ranges::size(view) == 5);
+      }
+    }
+    WHEN("assigning through the iterators") {
+      std::ranges::fill(buffer, 0);
+      THEN("the elements are changed in place") {
+        CHECK(std::accumulate(buffer.begin(), buffer.end(), 0) == 0);
+        CHECK(buffer.size() == 5);
+      }
+    }
+    WHEN("visiting the elements segment by segment") {
+      std::vector<int> visited;
+      std::as_const(buffer).for_each_segmented([&visited](int e) { visited.push_back(e); });
+      buffer.for_each_segmented([](int& e) { e *= 2; });
+      THEN("every element is visited once, oldest first") {
+        CHECK(visited == std::vector<int>{3, 4, 5, 6, 7});
+        CHECK(std::vector<int>(buffer.begin(), buffer.end()) == std::vector<int>{6, 8, 10, 12, 14});
+      }
+    }
+  }
+  GIVEN("an empty buffer") {
+    const Buffer buffer{};
+    THEN("its range is empty") {
+      CHECK(buffer.begin() == buffer.end());
+      CHECK(buffer.empty());
+      CHECK(buffer.view().empty());
+    }
+  }
+  GIVEN("a full buffer of elements that count their copies") {
+    using Life = Lifetime<std::string>;
+    my::Ring_buffer<Life, 3> buffer{};
+    for (int i = 0; i < 4; i++) {
+      buffer.emplace(std::to_string(i));
+    }
+    Life::reset();
+    WHEN("computing over the elements") {
+      std::size_t length = 0;
+      for (const auto& e : buffer) {
+        length += e.content.size();
+      }
+      THEN("nothing is copied or moved") {
+        CHECK(length == 3);
+        CHECK(Life::copy_constructed == 0);
+        CHECK(Life::move_constructed == 0);
+      }
+    }
+  }
+}
@@ -6,20 +6,86 @@
  * object itself. It means that should a Ring_buffer be declared as
  * a local variable, its elements are allocated on the stack.
  * 
- * Multi-thread support is ???
+ * The built-in buffer is raw storage suitably aligned for T. An element
+ * is constructed in its slot when it is pushed and destroyed when it is
+ * popped, so T need not be default-constructible and an empty buffer
+ * constructs nothing. `emplace()` constructs the element in its slot
+ * from the given arguments.
  * 
- * The `push()` method of a Ring_buffer object copies/moves the
- * argument into a buffer built in the object. If the buffer is full,
- * the method will not wait but overwrite the oldest element in the
- * buffer with the argument.
+ * What happens when the buffer is full is chosen at compile time by
+ * the Policy parameter (see full_policy.hpp):
+ * - Overwrite (default): `push()` overwrites the oldest element in the
+ *   buffer with the argument.
+ * - Reject: there is no `push()`; `try_push()` returns false and leaves
+ *   the buffer untouched.
+ * - Block: `push()` parks the thread until the consumer pops an element,
+ *   and `pop()` parks the thread until the producer pushes an element.
+ * Since the policy is a template parameter, the branches for the other
+ * policies are discarded at compile time.
+ * 
+ * With Overwrite and Reject, Ring_buffer is not thread-safe. To share
+ * a buffer between one producer thread and one consumer thread without
+ * a mutex, use Spsc_ring_buffer in spsc_ring_buffer.hpp instead. With
+ * Block, one producer thread and one consumer thread may share the
+ * buffer: the indices become atomics, which are also what the threads
+ * wait on.
+ * 
+ * If N is a power of two, the indices are free-running 64-bit counters
+ * masked with N-1, and the number of elements is their difference.
+ * Otherwise they are wrapped with `% N` and the number of elements is
+ * kept in a separate count (see ring_index.hpp).
+ * 
+ * The `push()` and `try_push()` methods of a Ring_buffer object
+ * copy/move the argument into a buffer built in the object, and the
+ * `emplace()` and `try_emplace()` methods construct it there. Each
+ * copies/moves the element exactly once. With Overwrite and a full
+ * buffer, `push()` and `try_push()` copy/move-assign the argument over
+ * the oldest element instead of destroying it and constructing anew.
  * 
  * The `pop()` method may return the oldest element in the buffer. The
  * returned value will be virtually removed from the buffer. If the buffer
- * is empty, `optional.empty` is returned.
+ * is empty, `optional.empty` is returned, except with Block where the
+ * method waits for an element.
+ * 
+ * The bulk methods `push_n()` and `pop_n()` copy/move a whole span of
+ * elements in at most two contiguous chunks, one on each side of the
+ * wrap-around point, so they do the index arithmetic once per call
+ * rather than once per element. For trivially copyable T each chunk
+ * is a single memmove. `peek_contiguous()` exposes the same two chunks
+ * of the live region without copying; `discard()` then drops what the
+ * caller has consumed.
+ * 
+ * The buffer is also a random-access range of its live elements,
+ * oldest first: `begin()`/`end()` (see ring_iterator.hpp) and `view()`
+ * read the elements in place without popping them, so std and
+ * std::ranges algorithms run over the buffer without copies or
+ * optionals. `for_each_segmented()` calls a function on every element
+ * in two plain loops over the contiguous chunks, which the compiler
+ * can vectorize, instead of wrapping the index at every step. With
+ * Block, none of these may run while another thread pushes or pops.
+ * 
+ * With the Stats parameter set to Ring_stats (see ring_stats.hpp), the
+ * buffer counts pushes, pops, overwritten and rejected pushes, pops
+ * from an empty buffer and its high-water mark; `stats()` returns a
+ * snapshot of them. With the default No_stats, none of this is
+ * compiled in.
  */
+#pragma once
+
+#include "full_policy.hpp"
+#include "ring_index.hpp"
+#include "ring_iterator.hpp"
+#include "ring_stats.hpp"
 #include <cstddef>
 #include <optional>
+#include <algorithm>
 #include <array>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 namespace my {
 
@@ -28,23 +94,86 @@ namespace my {
  * 
  * @tparam T The element stored in a built-in buffer.
  * @tparam N The maximum number of elements in the buffer.
+ * @tparam Policy Overwrite, Reject or Block.
+ * @tparam Stats No_stats or Ring_stats.
  */
-template<typename T, std::size_t N>
+template<typename T, std::size_t N, typename Policy = Overwrite, typename Stats = No_stats>
 class Ring_buffer {
+  static_assert(std::is_same_v<Policy, Overwrite>
+    || std::is_same_v<Policy, Reject>
+    || std::is_same_v<Policy, Block>);
+  static_assert(N > 0);
+
+  static constexpr bool blocking = std::is_same_v<Policy, Block>;
+
 public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = Ring_iterator<T, N>;
+  using const_iterator = Ring_iterator<const T, N>;
+
+  // user-provided, so that `Ring_buffer b{};` does not zero the storage
+  Ring_buffer() {}
+  Ring_buffer(const Ring_buffer&) requires (!blocking);
+  Ring_buffer(Ring_buffer&&) requires (!blocking);
+  Ring_buffer& operator=(const Ring_buffer&) requires (!blocking);
+  Ring_buffer& operator=(Ring_buffer&&) requires (!blocking);
+  ~Ring_buffer();
+
   /**
    * Copies the argument into a buffer built in the instance.
    * 
    * @param T The element to be copied into the buffer.
    */
-  void push(const T&);
+  void push(const T&) requires (!std::is_same_v<Policy, Reject>);
 
   /**
    * Moves the argument into a buffer built in the instance.
    * 
    * @param T The element to be moved into the buffer.
    */
-  void push(T&&);
+  void push(T&&) requires (!std::is_same_v<Policy, Reject>);
+
+  /**
+   * Constructs an element from the arguments directly in a buffer
+   * built in the instance.
+   * 
+   * @param args The arguments passed to the constructor of T.
+   */
+  template<typename... Args>
+  void emplace(Args&&... args) requires (!std::is_same_v<Policy, Reject>);
+
+  /**
+   * Copies the argument into a buffer built in the instance unless
+   * the buffer is full. Never waits, even with Block.
+   * 
+   * @param T The element to be copied into the buffer.
+   * @return false if the buffer is full and Policy is not Overwrite,
+   * true otherwise.
+   */
+  bool try_push(const T&);
+
+  /**
+   * Moves the argument into a buffer built in the instance unless
+   * the buffer is full. Never waits, even with Block.
+   * 
+   * @param T The element to be moved into the buffer.
+   * @return false if the buffer is full and Policy is not Overwrite,
+   * true otherwise.
+   */
+  bool try_push(T&&);
+
+  /**
+   * Constructs an element from the arguments directly in a buffer
+   * built in the instance unless the buffer is full. Never waits,
+   * even with Block.
+   * 
+   * @param args The arguments passed to the constructor of T.
+   * @return false if the buffer is full and Policy is not Overwrite,
+   * true otherwise.
+   */
+  template<typename... Args>
+  bool try_emplace(Args&&... args);
 
   /**
    * Returns the oldest element in the buffer.
@@ -54,45 +183,454 @@ public:
    */
   std::optional<T> pop();
 
+  /**
+   * Copies the elements of the argument into a buffer built in the
+   * instance, first element first. With Overwrite, all of them are
+   * pushed, and only the last N survive if there are more than N.
+   * With Reject, as many as fit are pushed. With Block, the method
+   * waits until all of them are pushed.
+   * 
+   * @param elements The elements to be copied into the buffer.
+   * @return The number of elements pushed.
+   */
+  std::size_t push_n(std::span<const T> elements);
+
+  /**
+   * Moves the oldest elements in the buffer into the argument, oldest
+   * first. With Block, the method waits until at least one element
+   * is available.
+   * 
+   * @param elements The span that receives the elements.
+   * @return The number of elements popped, which is at most the size
+   * of the argument.
+   */
+  std::size_t pop_n(std::span<T> elements);
+
+  /**
+   * Returns the elements in the buffer without removing them, oldest
+   * first. The first span runs from the oldest element to the end of
+   * the built-in buffer or the newest element; the second span, which
+   * may be empty, holds the elements that wrapped around to the front.
+   * The spans are valid until the next push into the buffer.
+   * 
+   * @return The live region as at most two non-empty spans.
+   */
+  std::array<std::span<const T>, 2> peek_contiguous() const;
+
+  /**
+   * Removes at most n oldest elements without returning them, e.g.
+   * after reading them through `peek_contiguous()`.
+   * 
+   * @param n The number of elements to be removed.
+   * @return The number of elements removed.
+   */
+  std::size_t discard(std::size_t n);
+
+  /**
+   * @return The number of elements in the buffer.
+   */
+  std::size_t size() const { return idx.size(); }
+  bool empty() const { return idx.size() == 0; }
+
+  /**
+   * Returns iterators over the elements in the buffer, oldest first.
+   * They are valid until the next push, pop or discard.
+   */
+  iterator begin() { return {slot(0), idx.read_slot(), 0}; }
+  iterator end() { return begin() + static_cast<std::ptrdiff_t>(idx.size()); }
+  const_iterator begin() const { return {slot(0), idx.read_slot(), 0}; }
+  const_iterator end() const { return begin() + static_cast<std::ptrdiff_t>(idx.size()); }
+
+  /**
+   * Returns a read-only view over the elements in the buffer, oldest
+   * first, e.g. for `view() | std::views::reverse`.
+   * 
+   * @return A sized random-access view, valid as long as the iterators.
+   */
+  std::ranges::subrange<const_iterator> view() const { return {begin(), end()}; }
+
+  /**
+   * Calls f on every element in the buffer, oldest first, in one loop
+   * per contiguous chunk.
+   * 
+   * @param f A function that takes a T& or a const T&.
+   */
+  template<typename F>
+  void for_each_segmented(F f);
+  template<typename F>
+  void for_each_segmented(F f) const;
+
+  /**
+   * Returns the counters kept by the Stats policy. It may be called
+   * from any thread.
+   * 
+   * @return A copy of the counters, all zero with No_stats.
+   */
+  Ring_stats_snapshot stats() const { return counters.snapshot(); }
+
   private:
-  std::array<T, N> buffer{};
-  std::size_t write_idx{0};
-  std::size_t read_idx{0};
-  std::size_t count{0};
+  bool full() const;
+  void make_room(std::size_t n);
+  void drop(std::size_t n);
+  void count_pushed(std::size_t n);
+  template<typename U>
+  void put(U&& e);
+  void copy_in(std::span<const T> elements);
+  template<typename Other>
+  void assign_from(Other&& other);
+
+  T* slot(std::size_t i) {
+    return std::launder(reinterpret_cast<T*>(buffer) + i);
+  }
+  const T* slot(std::size_t i) const {
+    return std::launder(reinterpret_cast<const T*>(buffer) + i);
+  }
+
+  alignas(T) std::byte buffer[N * sizeof(T)];
+  Ring_index<N, blocking> idx{};
+  [[no_unique_address]] Stats counters{};
 };
 
-template<typename T, std::size_t N>
-void Ring_buffer<T, N>::push(const T& e) {
-  buffer[write_idx] = e;
-  write_idx = (write_idx + 1) % N;
-  if (count < N) {
-    count++;
+template<typename T, std::size_t N, typename Policy, typename Stats>
+Ring_buffer<T, N, Policy, Stats>::Ring_buffer(const Ring_buffer& other)
+requires (!blocking) {
+  assign_from(other);
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+Ring_buffer<T, N, Policy, Stats>::Ring_buffer(Ring_buffer&& other)
+requires (!blocking) {
+  assign_from(std::move(other));
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+Ring_buffer<T, N, Policy, Stats>& Ring_buffer<T, N, Policy, Stats>::operator=(const Ring_buffer& other)
+requires (!blocking) {
+  if (this != &other) {
+    drop(idx.size());
+    assign_from(other);
+  }
+  return *this;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+Ring_buffer<T, N, Policy, Stats>& Ring_buffer<T, N, Policy, Stats>::operator=(Ring_buffer&& other)
+requires (!blocking) {
+  if (this != &other) {
+    drop(idx.size());
+    assign_from(std::move(other));
+  }
+  return *this;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+Ring_buffer<T, N, Policy, Stats>::~Ring_buffer() {
+  drop(idx.size());
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::push(const T& e)
+requires (!std::is_same_v<Policy, Reject>) {
+  if constexpr (blocking) {
+    idx.wait_while_full();
+  }
+  put(e);
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::push(T&& e)
+requires (!std::is_same_v<Policy, Reject>) {
+  if constexpr (blocking) {
+    idx.wait_while_full();
+  }
+  put(std::move(e));
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename... Args>
+void Ring_buffer<T, N, Policy, Stats>::emplace(Args&&... args)
+requires (!std::is_same_v<Policy, Reject>) {
+  if constexpr (blocking) {
+    idx.wait_while_full();
+  } else {
+    make_room(1);
+  }
+  std::construct_at(slot(idx.write_slot()), std::forward<Args>(args)...);
+  idx.pushed(1);
+  count_pushed(1);
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+bool Ring_buffer<T, N, Policy, Stats>::try_push(const T& e) {
+  if (full()) {
+    counters.rejected(1);
+    return false;
+  }
+  put(e);
+  return true;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+bool Ring_buffer<T, N, Policy, Stats>::try_push(T&& e) {
+  if (full()) {
+    counters.rejected(1);
+    return false;
+  }
+  put(std::move(e));
+  return true;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename... Args>
+bool Ring_buffer<T, N, Policy, Stats>::try_emplace(Args&&... args) {
+  if (full()) {
+    counters.rejected(1);
+    return false;
+  }
+  make_room(1);
+  std::construct_at(slot(idx.write_slot()), std::forward<Args>(args)...);
+  idx.pushed(1);
+  count_pushed(1);
+  return true;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+std::optional<T> Ring_buffer<T, N, Policy, Stats>::pop() {
+  if constexpr (blocking) {
+    idx.wait_while_empty();
+  } else {
+    if (idx.size() == 0) {
+      counters.empty_pop();
+      return {};
+    }
+  }
+  // destroys the element after it has been moved into the return
+  // value, which is constructed in place in the caller
+  struct Release {
+    Ring_buffer& buffer;
+    T* e;
+    ~Release() {
+      std::destroy_at(e);
+      buffer.idx.popped(1);
+      buffer.counters.popped(1);
+    }
+  } release{*this, slot(idx.read_slot())};
+
+  return std::optional<T>{std::move(*release.e)};
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+std::size_t Ring_buffer<T, N, Policy, Stats>::push_n(std::span<const T> elements) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    if (elements.size() > N) {
+      elements = elements.last(N);
+    }
+    make_room(elements.size());
+    copy_in(elements);
+    idx.pushed(elements.size());
+    count_pushed(elements.size());
+    return elements.size();
+  } else if constexpr (std::is_same_v<Policy, Reject>) {
+    const auto total = elements.size();
+    elements = elements.first(std::min(total, N - idx.size()));
+    copy_in(elements);
+    idx.pushed(elements.size());
+    count_pushed(elements.size());
+    if (elements.size() < total) {
+      counters.rejected(total - elements.size());
+    }
+    return elements.size();
   } else {
-    read_idx = (read_idx + 1) % N;
+    const auto total = elements.size();
+    while (!elements.empty()) {
+      idx.wait_while_full();
+      const auto chunk = elements.first(std::min(elements.size(), N - idx.size()));
+      copy_in(chunk);
+      idx.pushed(chunk.size());
+      count_pushed(chunk.size());
+      elements = elements.subspan(chunk.size());
+    }
+    return total;
+  }
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+std::size_t Ring_buffer<T, N, Policy, Stats>::pop_n(std::span<T> elements) {
+  if constexpr (blocking) {
+    if (elements.empty()) {
+      return 0;
+    }
+    idx.wait_while_empty();
+  }
+  const auto n = std::min(elements.size(), idx.size());
+  const auto read_idx = idx.read_slot();
+  const auto first = std::min(n, N - read_idx);
+  auto out = std::move(slot(read_idx), slot(read_idx) + first, elements.begin());
+  std::move(slot(0), slot(0) + (n - first), out);
+  drop(n);
+  if (n > 0) {
+    counters.popped(n);
+  } else if (!elements.empty()) {
+    counters.empty_pop();
+  }
+  return n;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename F>
+void Ring_buffer<T, N, Policy, Stats>::for_each_segmented(F f) {
+  const auto n = idx.size();
+  const auto read_idx = idx.read_slot();
+  const auto first = std::min(n, N - read_idx);
+  for (T *e = slot(read_idx), *last = e + first; e != last; ++e) {
+    f(*e);
+  }
+  for (T *e = slot(0), *last = e + (n - first); e != last; ++e) {
+    f(*e);
   }
 }
 
-template<typename T, std::size_t N>
-void Ring_buffer<T, N>::push(T&& e) {
-  std::swap(buffer[write_idx], e);
-  write_idx = (write_idx + 1) % N;
-  if (count < N) {
-    count++;
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename F>
+void Ring_buffer<T, N, Policy, Stats>::for_each_segmented(F f) const {
+  for (const auto& chunk : peek_contiguous()) {
+    for (const T& e : chunk) {
+      f(e);
+    }
+  }
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+std::array<std::span<const T>, 2> Ring_buffer<T, N, Policy, Stats>::peek_contiguous() const {
+  const auto n = idx.size();
+  const auto read_idx = idx.read_slot();
+  const auto first = std::min(n, N - read_idx);
+  return {
+    std::span<const T>{slot(read_idx), first},
+    std::span<const T>{slot(0), n - first}
+  };
+}
+
+template<typename T, std::size_t N, typename Policy, typename Stats>
+std::size_t Ring_buffer<T, N, Policy, Stats>::discard(std::size_t n) {
+  n = std::min(n, idx.size());
+  drop(n);
+  counters.popped(n);
+  return n;
+}
+
+/**
+ * Overwrite never considers the buffer full; it makes room instead.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+bool Ring_buffer<T, N, Policy, Stats>::full() const {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    return false;
   } else {
-    read_idx = (read_idx + 1) % N;
+    return idx.size() == N;
+  }
+}
+
+/**
+ * With Overwrite, drops as many oldest elements as needed to push n
+ * more. The other policies never push into a full buffer.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::make_room(std::size_t n) {
+  if constexpr (std::is_same_v<Policy, Overwrite>) {
+    const auto size = idx.size();
+    if (size + n > N) {
+      drop(size + n - N);
+      counters.overwritten(size + n - N);
+    }
+  }
+}
+
+/**
+ * Destroys the n oldest elements, which must be live.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::drop(std::size_t n) {
+  const auto read_idx = idx.read_slot();
+  const auto first = std::min(n, N - read_idx);
+  std::destroy(slot(read_idx), slot(read_idx) + first);
+  std::destroy(slot(0), slot(0) + (n - first));
+  idx.popped(n);
+}
+
+/**
+ * Reads the number of live elements only if it is recorded, since
+ * with Block that is an atomic load.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::count_pushed(std::size_t n) {
+  if constexpr (Stats::enabled) {
+    counters.pushed(n, idx.size());
   }
 }
 
-template<typename T, std::size_t N>
-std::optional<T> Ring_buffer<T, N>::pop() {
-  if (count == 0) {
-    return {};
+/**
+ * Copies/moves the argument into the slot to write, which must not be
+ * full unless Policy is Overwrite. With Overwrite and a full buffer,
+ * that slot holds the oldest element, so it is assigned over and the
+ * oldest element is gone.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename U>
+void Ring_buffer<T, N, Policy, Stats>::put(U&& e) {
+  if constexpr (std::is_same_v<Policy, Overwrite> && std::is_assignable_v<T&, U&&>) {
+    if (idx.size() == N) {
+      *slot(idx.write_slot()) = std::forward<U>(e);
+      idx.popped(1);
+      idx.pushed(1);
+      counters.overwritten(1);
+      count_pushed(1);
+      return;
+    }
   }
-  auto idx = read_idx;
-  read_idx = (read_idx + 1) % N;
-  count--;
+  make_room(1);
+  std::construct_at(slot(idx.write_slot()), std::forward<U>(e));
+  idx.pushed(1);
+  count_pushed(1);
+}
 
-  return std::move(buffer[idx]);
+/**
+ * Copies at most N - write_slot() elements up to the end of the
+ * built-in buffer, and the rest to its front. The slots must be free.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+void Ring_buffer<T, N, Policy, Stats>::copy_in(std::span<const T> elements) {
+  const auto write_idx = idx.write_slot();
+  const auto first = std::min(elements.size(), N - write_idx);
+  std::uninitialized_copy(elements.begin(), elements.begin() + first, slot(write_idx));
+  std::uninitialized_copy(elements.begin() + first, elements.end(), slot(0));
+}
+
+/**
+ * Copies/moves the elements of the other buffer into this empty one,
+ * oldest first. If an element throws, the elements built so far are
+ * destroyed, since a constructor that throws runs no destructor, and
+ * this buffer is left empty.
+ */
+template<typename T, std::size_t N, typename Policy, typename Stats>
+template<typename Other>
+void Ring_buffer<T, N, Policy, Stats>::assign_from(Other&& other) {
+  const auto n = other.idx.size();
+  const auto read_idx = other.idx.read_slot();
+  try {
+    for (std::size_t i = 0; i < n; i++) {
+      auto& e = *other.slot((read_idx + i) % N);
+      if constexpr (std::is_lvalue_reference_v<Other>) {
+        std::construct_at(slot(idx.write_slot()), e);
+      } else {
+        std::construct_at(slot(idx.write_slot()), std::move(e));
+      }
+      idx.pushed(1);
+    }
+  } catch (...) {
+    drop(idx.size());
+    throw;
+  }
 }
 
 }
@@ -0,0 +1,248 @@
+/**
+ * Benchmarks of the ring buffer variants, run with the harness in
+ * bench.hpp. Every benchmark is run for each payload from `int` to a
+ * 1 KB struct, in buffers of 1024 elements:
+ * - Ring_buffer/push_pop: one push and one pop per iteration on a half
+ *   full buffer, on one thread. Ring_buffer<int, 1000> (indices wrapped
+ *   with `% N`) is measured against Ring_buffer<int, 1024> (free-running
+ *   counters masked with N-1).
+ * - Ring_buffer/push_latency, Ring_buffer/pop_latency: percentiles of
+ *   a single push or pop.
+ * - Ring_buffer<Block>/spsc, Spsc_ring_buffer/spsc: one element per
+ *   iteration from a producer thread to a consumer thread.
+ * - Mpmc_queue/mpmc: one element per iteration from k producer threads
+ *   to k consumer threads, for k = 1, 2, 4, ... up to half the CPUs.
+ * - Ring_buffer/copy, Ring_buffer/move: pushing a std::string or
+ *   std::vector by `push(const T&)` against `push(T&&)`.
+ *
+ * Build with optimization and run, e.g.
+ *     clang++ -std=c++23 -O2 -DNDEBUG ring_buffer_bench.cpp -o ring_buffer_bench
+ *     ./ring_buffer_bench --out=before.json
+ * See bench.hpp for the command-line options.
+ */
+#include "bench.hpp"
+#include "mpmc_queue.hpp"
+#include "ring_buffer.hpp"
+#include "spsc_ring_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using my::bench::do_not_optimize;
+using my::bench::Payload;
+
+constexpr std::size_t capacity = 1024;
+constexpr std::size_t latency_samples = 1'000'000;
+
+/**
+ * The buffers are allocated on the heap, since with 1 KB payloads
+ * they are too large for the stack.
+ */
+template<typename Buffer>
+std::unique_ptr<Buffer> make_buffer() {
+  return std::make_unique<Buffer>();
+}
+
+/**
+ * Keeps the buffer half full and does one push and one pop per
+ * iteration, so both indices keep wrapping around.
+ */
+template<typename T, std::size_t N>
+void push_pop(std::uint64_t iterations) {
+  auto buffer = make_buffer<my::Ring_buffer<T, N>>();
+  const T element{};
+  for (std::size_t i = 0; i < N / 2; i++) {
+    buffer->push(element);
+  }
+  for (std::uint64_t i = 0; i < iterations; i++) {
+    buffer->push(element);
+    auto popped = buffer->pop();
+    do_not_optimize(popped);
+  }
+}
+
+template<typename T>
+void push_latency(my::bench::Latency_recorder& recorder) {
+  auto buffer = make_buffer<my::Ring_buffer<T, capacity>>();
+  const T element{};
+  while (!recorder.done()) {
+    recorder.measure([&] { buffer->push(element); });
+    auto popped = buffer->pop();
+    do_not_optimize(popped);
+  }
+}
+
+template<typename T>
+void pop_latency(my::bench::Latency_recorder& recorder) {
+  auto buffer = make_buffer<my::Ring_buffer<T, capacity>>();
+  const T element{};
+  while (!recorder.done()) {
+    buffer->push(element);
+    std::optional<T> popped;
+    recorder.measure([&] { popped = buffer->pop(); });
+    do_not_optimize(popped);
+  }
+}
+
+/**
+ * Passes iterations elements from thread 0 to thread 1 through a
+ * Ring_buffer that blocks when full or empty.
+ */
+template<typename T>
+void blocking_spsc(std::uint64_t iterations) {
+  auto buffer = make_buffer<my::Ring_buffer<T, capacity, my::Block>>();
+  my::bench::run_threads(2, [&](std::size_t thread) {
+    if (thread == 0) {
+      const T element{};
+      for (std::uint64_t i = 0; i < iterations; i++) {
+        buffer->push(element);
+      }
+    } else {
+      for (std::uint64_t i = 0; i < iterations; i++) {
+        auto popped = buffer->pop();
+        do_not_optimize(popped);
+      }
+    }
+  });
+}
+
+/**
+ * Passes iterations elements from thread 0 to thread 1 through a
+ * Spsc_ring_buffer, yielding while it is full or empty.
+ */
+template<typename T>
+void lock_free_spsc(std::uint64_t iterations) {
+  auto buffer = make_buffer<my::Spsc_ring_buffer<T, capacity, my::Cache_aligned>>();
+  my::bench::run_threads(2, [&](std::size_t thread) {
+    if (thread == 0) {
+      const T element{};
+      for (std::uint64_t i = 0; i < iterations; i++) {
+        while (!buffer->push(element)) {
+          std::this_thread::yield();
+        }
+      }
+    } else {
+      for (std::uint64_t i = 0; i < iterations;) {
+        if (auto popped = buffer->pop()) {
+          do_not_optimize(popped);
+          i++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+/**
+ * Passes iterations elements from `pairs` producer threads to as many
+ * consumer threads through an Mpmc_queue.
+ */
+template<typename T>
+void mpmc(std::size_t pairs, std::uint64_t iterations) {
+  auto queue = make_buffer<my::Mpmc_queue<T, capacity>>();
+  std::atomic<std::uint64_t> remaining{iterations};
+  my::bench::run_threads(2 * pairs, [&](std::size_t thread) {
+    if (thread < pairs) {
+      // producer i pushes every pairs-th element, starting at i
+      const T element{};
+      for (std::uint64_t i = thread; i < iterations; i += pairs) {
+        while (!queue->try_push(element)) {
+          std::this_thread::yield();
+        }
+      }
+    } else {
+      while (remaining.load(std::memory_order_relaxed) > 0) {
+        if (auto popped = queue->try_pop()) {
+          do_not_optimize(popped);
+          remaining.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+}
+
+/**
+ * Pushes a copy of the payload and pops it again per iteration.
+ */
+template<typename T>
+void copy_in(const T& payload, std::uint64_t iterations) {
+  my::Ring_buffer<T, 64> buffer{};
+  for (std::uint64_t i = 0; i < iterations; i++) {
+    buffer.push(payload);
+    auto element = buffer.pop();
+    do_not_optimize(element);
+  }
+}
+
+/**
+ * Cycles 64 payloads through the buffer: each iteration pops the
+ * oldest and moves it back in, so no payload is ever allocated or
+ * copied.
+ */
+template<typename T>
+void move_in(const T& payload, std::uint64_t iterations) {
+  my::Ring_buffer<T, 64> buffer{};
+  for (std::size_t i = 0; i < 64; i++) {
+    buffer.push(payload);
+  }
+  for (std::uint64_t i = 0; i < iterations; i++) {
+    auto element = buffer.pop();
+    buffer.push(std::move(*element));
+    do_not_optimize(element);
+  }
+}
+
+template<typename T>
+void add_payload(my::bench::Suite& suite) {
+  const auto bytes = sizeof(T);
+  const auto suffix = "/" + std::to_string(bytes);
+  const std::uint64_t threads = std::max(2u, std::thread::hardware_concurrency());
+
+  suite.add({"Ring_buffer/push_pop" + suffix, 1, bytes}, push_pop<T, capacity>);
+  suite.add_latency({"Ring_buffer/push_latency" + suffix, 1, bytes}, latency_samples, push_latency<T>);
+  suite.add_latency({"Ring_buffer/pop_latency" + suffix, 1, bytes}, latency_samples, pop_latency<T>);
+  suite.add({"Ring_buffer<Block>/spsc" + suffix, 2, bytes}, blocking_spsc<T>);
+  suite.add({"Spsc_ring_buffer/spsc" + suffix, 2, bytes}, lock_free_spsc<T>);
+  for (std::size_t pairs = 1; 2 * pairs <= threads; pairs *= 2) {
+    suite.add({"Mpmc_queue/mpmc" + suffix + "/threads:" + std::to_string(2 * pairs), 2 * pairs, bytes},
+      [pairs](std::uint64_t iterations) { mpmc<T>(pairs, iterations); });
+  }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+  my::bench::Suite suite;
+
+  suite.add({"Ring_buffer/push_pop/N:1000", 1, sizeof(int)}, push_pop<int, 1000>);
+  suite.add({"Ring_buffer/push_pop/N:1024", 1, sizeof(int)}, push_pop<int, 1024>);
+
+  add_payload<int>(suite);
+  add_payload<Payload<64>>(suite);
+  add_payload<Payload<256>>(suite);
+  add_payload<Payload<1024>>(suite);
+
+  const std::string text(256, 'x');
+  const std::vector<double> samples(256, 1.0);
+  suite.add({"Ring_buffer/copy/std::string(256)", 1, sizeof(text)},
+    [&text](std::uint64_t iterations) { copy_in(text, iterations); });
+  suite.add({"Ring_buffer/move/std::string(256)", 1, sizeof(text)},
+    [&text](std::uint64_t iterations) { move_in(text, iterations); });
+  suite.add({"Ring_buffer/copy/std::vector<double>(256)", 1, sizeof(samples)},
+    [&samples](std::uint64_t iterations) { copy_in(samples, iterations); });
+  suite.add({"Ring_buffer/move/std::vector<double>(256)", 1, sizeof(samples)},
+    [&samples](std::uint64_t iterations) { move_in(samples, iterations); });
+
+  return suite.main(argc, argv);
+}
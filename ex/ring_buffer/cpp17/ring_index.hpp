@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @brief Index bookkeeping for fixed-capacity ring buffers.
+ *
+ * Both types answer the same questions for a buffer of N slots: which
+ * slot to write next, which slot holds the oldest element, and how
+ * many elements are live. Ring_buffer picks one of them at compile
+ * time depending on N.
+ *
+ * Wrapped_indices keeps the two slot indices in [0, N) and a separate
+ * count. Advancing an index costs `% N`, which for a generic N that is
+ * not folded into a constant is a division.
+ *
+ * Free_running_counters requires N to be a power of two. It keeps two
+ * 64-bit counters that are never wrapped: the slot is `counter & (N-1)`
+ * and the count is `head - tail`, so there is neither a division nor
+ * a separate count. A 64-bit counter does not overflow in practice.
+ *
+ * With Shared, one producer thread and one consumer thread may use the
+ * state concurrently. The variables become atomics, published with
+ * release stores and read with acquire loads, and the waiting methods
+ * park the calling thread in `std::atomic::wait()`.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace my {
+
+template<std::size_t N, bool Shared>
+class Wrapped_indices {
+public:
+  std::size_t write_slot() const { return write_idx; }
+  std::size_t read_slot() const { return read_idx; }
+
+  std::size_t size() const {
+    if constexpr (Shared) {
+      return count.load(std::memory_order_acquire);
+    } else {
+      return count;
+    }
+  }
+
+  /**
+   * Records that n elements were written from write_slot(). The
+   * caller has made sure that at least n slots were free.
+   */
+  void pushed(std::size_t n) {
+    write_idx = (write_idx + n) % N;
+    if constexpr (Shared) {
+      // the consumer waits only after it has seen an empty buffer
+      if (n > 0 && count.fetch_add(n, std::memory_order_acq_rel) == 0) {
+        count.notify_one();
+      }
+    } else {
+      count += n;
+    }
+  }
+
+  /**
+   * Records that n elements were read from read_slot().
+   */
+  void popped(std::size_t n) {
+    read_idx = (read_idx + n) % N;
+    if constexpr (Shared) {
+      // the producer waits only after it has seen a full buffer
+      if (n > 0 && count.fetch_sub(n, std::memory_order_acq_rel) == N) {
+        count.notify_one();
+      }
+    } else {
+      count -= n;
+    }
+  }
+
+  void wait_while_full() requires Shared {
+    while (count.load(std::memory_order_acquire) == N) {
+      count.wait(N, std::memory_order_acquire);
+    }
+  }
+
+  void wait_while_empty() requires Shared {
+    while (count.load(std::memory_order_acquire) == 0) {
+      count.wait(0, std::memory_order_acquire);
+    }
+  }
+
+private:
+  std::size_t write_idx{0};
+  std::size_t read_idx{0};
+  std::conditional_t<Shared, std::atomic<std::size_t>, std::size_t> count{0};
+};
+
+template<std::size_t N, bool Shared>
+class Free_running_counters {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+  using counter_type = std::conditional_t<Shared, std::atomic<std::uint64_t>, std::uint64_t>;
+
+public:
+  std::size_t write_slot() const { return load(head, std::memory_order_relaxed) & (N - 1); }
+  std::size_t read_slot() const { return load(tail, std::memory_order_relaxed) & (N - 1); }
+
+  std::size_t size() const {
+    return load(head, std::memory_order_acquire) - load(tail, std::memory_order_acquire);
+  }
+
+  /**
+   * Records that n elements were written from write_slot(). The
+   * caller has made sure that at least n slots were free.
+   */
+  void pushed(std::size_t n) {
+    if constexpr (Shared) {
+      head.store(head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+      head.notify_one();
+    } else {
+      head += n;
+    }
+  }
+
+  /**
+   * Records that n elements were read from read_slot().
+   */
+  void popped(std::size_t n) {
+    if constexpr (Shared) {
+      tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+      tail.notify_one();
+    } else {
+      tail += n;
+    }
+  }
+
+  void wait_while_full() requires Shared {
+    for (;;) {
+      const auto t = tail.load(std::memory_order_acquire);
+      if (head.load(std::memory_order_relaxed) - t != N) {
+        return;
+      }
+      tail.wait(t, std::memory_order_acquire);
+    }
+  }
+
+  void wait_while_empty() requires Shared {
+    for (;;) {
+      const auto h = head.load(std::memory_order_acquire);
+      if (h != tail.load(std::memory_order_relaxed)) {
+        return;
+      }
+      head.wait(h, std::memory_order_acquire);
+    }
+  }
+
+private:
+  static std::uint64_t load(const counter_type& c, std::memory_order order) {
+    if constexpr (Shared) {
+      return c.load(order);
+    } else {
+      return c;
+    }
+  }
+
+  counter_type head{0};
+  counter_type tail{0};
+};
+
+/**
+ * Free_running_counters if N is a power of two, Wrapped_indices
+ * otherwise.
+ */
+template<std::size_t N, bool Shared>
+using Ring_index = std::conditional_t<(N & (N - 1)) == 0,
+  Free_running_counters<N, Shared>, Wrapped_indices<N, Shared>>;
+
+}
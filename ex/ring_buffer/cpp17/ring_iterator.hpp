@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @brief A random-access iterator over the live elements of a ring of
+ * N slots, oldest first.
+ *
+ * The iterator holds the address of slot 0, the slot of the oldest
+ * element and its distance from the oldest element. Dereferencing
+ * adds the two and wraps the sum with a compare and a subtract rather
+ * than `% N`, since the sum is always below 2N.
+ *
+ * Iterating does not remove anything. An iterator is invalidated by
+ * any push, pop or discard on the buffer it came from.
+ *
+ * @tparam T The element type, const-qualified for a const_iterator.
+ * @tparam N The number of slots in the ring.
+ */
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace my {
+
+template<typename T, std::size_t N>
+class Ring_iterator {
+public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  Ring_iterator() = default;
+  Ring_iterator(T* slots, std::size_t oldest, difference_type pos)
+    : slots{slots}, oldest{oldest}, pos{pos} {}
+
+  // an iterator converts to a const_iterator
+  template<typename U>
+  requires std::is_same_v<const U, T>
+  Ring_iterator(const Ring_iterator<U, N>& other)
+    : slots{other.slots}, oldest{other.oldest}, pos{other.pos} {}
+
+  reference operator*() const {
+    auto i = oldest + static_cast<std::size_t>(pos);
+    if (i >= N) {
+      i -= N;
+    }
+    return slots[i];
+  }
+  pointer operator->() const { return &**this; }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  Ring_iterator& operator++() { ++pos; return *this; }
+  Ring_iterator operator++(int) { auto old = *this; ++pos; return old; }
+  Ring_iterator& operator--() { --pos; return *this; }
+  Ring_iterator operator--(int) { auto old = *this; --pos; return old; }
+  Ring_iterator& operator+=(difference_type n) { pos += n; return *this; }
+  Ring_iterator& operator-=(difference_type n) { pos -= n; return *this; }
+
+  friend Ring_iterator operator+(Ring_iterator it, difference_type n) { return it += n; }
+  friend Ring_iterator operator+(difference_type n, Ring_iterator it) { return it += n; }
+  friend Ring_iterator operator-(Ring_iterator it, difference_type n) { return it -= n; }
+  friend difference_type operator-(const Ring_iterator& a, const Ring_iterator& b) {
+    return a.pos - b.pos;
+  }
+
+  // iterators into the same buffer compare by their distance from the oldest element
+  friend bool operator==(const Ring_iterator& a, const Ring_iterator& b) { return a.pos == b.pos; }
+  friend std::strong_ordering operator<=>(const Ring_iterator& a, const Ring_iterator& b) {
+    return a.pos <=> b.pos;
+  }
+
+private:
+  template<typename, std::size_t>
+  friend class Ring_iterator;
+
+  T* slots{nullptr};
+  std::size_t oldest{0};
+  difference_type pos{0};
+};
+
+}
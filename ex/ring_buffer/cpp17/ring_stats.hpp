@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @brief Statistics policies for Ring_buffer.
+ *
+ * No_stats (the default) counts nothing and takes no space in the
+ * buffer; the calls to it compile to nothing.
+ *
+ * Ring_stats counts pushes, pops, pushes that overwrote unread
+ * elements (Overwrite), pushes that were rejected (Reject), pops from
+ * an empty buffer, and the largest number of elements ever held. The
+ * counters are relaxed atomics so that a metrics thread can read them
+ * through `snapshot()` at any time.
+ *
+ * Each counter has a single writer: the producer updates the push-side
+ * counters and the consumer the pop-side ones, which sit on different
+ * cache lines. So an update is a relaxed load and store rather than a
+ * read-modify-write instruction.
+ */
+#include "cache_line.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace my {
+
+struct Ring_stats_snapshot {
+  std::uint64_t pushes{0};
+  std::uint64_t pops{0};
+  std::uint64_t overwrites{0};
+  std::uint64_t rejected_pushes{0};
+  std::uint64_t empty_pops{0};
+  std::uint64_t high_water_mark{0};
+};
+
+struct No_stats {
+  static constexpr bool enabled = false;
+
+  void pushed(std::size_t, std::size_t) {}
+  void popped(std::size_t) {}
+  void overwritten(std::size_t) {}
+  void rejected(std::size_t) {}
+  void empty_pop() {}
+
+  Ring_stats_snapshot snapshot() const { return {}; }
+};
+
+class Ring_stats {
+public:
+  static constexpr bool enabled = true;
+
+  /**
+   * Records n pushed elements, after which size elements are live.
+   */
+  void pushed(std::size_t n, std::size_t size) {
+    add(producer.pushes, n);
+    if (size > producer.high_water_mark.load(std::memory_order_relaxed)) {
+      producer.high_water_mark.store(size, std::memory_order_relaxed);
+    }
+  }
+  void popped(std::size_t n) { add(consumer.pops, n); }
+  void overwritten(std::size_t n) { add(producer.overwrites, n); }
+  void rejected(std::size_t n) { add(producer.rejected_pushes, n); }
+  void empty_pop() { add(consumer.empty_pops, 1); }
+
+  Ring_stats_snapshot snapshot() const {
+    return {
+      producer.pushes.load(std::memory_order_relaxed),
+      consumer.pops.load(std::memory_order_relaxed),
+      producer.overwrites.load(std::memory_order_relaxed),
+      producer.rejected_pushes.load(std::memory_order_relaxed),
+      consumer.empty_pops.load(std::memory_order_relaxed),
+      producer.high_water_mark.load(std::memory_order_relaxed)
+    };
+  }
+
+private:
+  using counter = std::atomic<std::uint64_t>;
+
+  static void add(counter& c, std::uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  struct alignas(cache_line_size) {
+    counter pushes{0};
+    counter overwrites{0};
+    counter rejected_pushes{0};
+    counter high_water_mark{0};
+  } producer;
+  struct alignas(cache_line_size) {
+    counter pops{0};
+    counter empty_pops{0};
+  } consumer;
+};
+
+}
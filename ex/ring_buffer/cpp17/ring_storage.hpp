@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @brief Storage policies for Dynamic_ring_buffer.
+ *
+ * A storage owns a block of raw memory whose size is chosen at run
+ * time. Every storage type provides:
+ * - `Storage(std::size_t bytes)`, where bytes is a multiple of
+ *   `granularity()`;
+ * - `std::byte* data() const`;
+ * - `static std::size_t granularity()`, the unit the size must be a
+ *   multiple of, e.g. the page size for mmap;
+ * - `static constexpr std::size_t alignment`, the alignment of data();
+ * - `static constexpr bool mirrored`, true if the `bytes` bytes right
+ *   after the block map the block itself again, so that a range that
+ *   wraps around the end of the block can be read contiguously.
+ *
+ * Heap_storage uses `operator new`. Mmap_storage maps anonymous memory,
+ * which suits captures of hundreds of megabytes that are awkward on the
+ * heap. Mirrored_storage maps a memfd twice, back to back.
+ *
+ * With Huge, the mmap-based storages ask for 2 MiB huge pages to cut
+ * TLB misses. If the system has no huge page pool, they fall back to
+ * normal pages and ask for transparent huge pages with madvise().
+ *
+ * The mmap-based storages are Linux-specific. Failures throw
+ * std::system_error.
+ */
+#include "cache_line.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <new>
+#include <system_error>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace my {
+
+inline constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+inline std::size_t page_size() {
+  static const auto size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+class Heap_storage {
+public:
+  static constexpr std::size_t alignment = cache_line_size;
+  static constexpr bool mirrored = false;
+  static std::size_t granularity() { return 1; }
+
+  explicit Heap_storage(std::size_t bytes)
+  : block{static_cast<std::byte*>(::operator new(bytes, std::align_val_t{alignment}))} {}
+
+  Heap_storage(const Heap_storage&) = delete;
+  Heap_storage& operator=(const Heap_storage&) = delete;
+
+  ~Heap_storage() {
+    ::operator delete(block, std::align_val_t{alignment});
+  }
+
+  std::byte* data() const { return block; }
+
+private:
+  std::byte* block;
+};
+
+template<bool Huge = false>
+class Mmap_storage {
+public:
+  static constexpr std::size_t alignment = 4096;
+  static constexpr bool mirrored = false;
+  static std::size_t granularity() { return Huge ? huge_page_size : page_size(); }
+
+  explicit Mmap_storage(std::size_t bytes) : bytes{bytes} {
+    void* p = MAP_FAILED;
+    if constexpr (Huge) {
+      p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (p == MAP_FAILED) {
+      p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED) {
+        throw std::system_error{errno, std::generic_category(), "mmap"};
+      }
+      if constexpr (Huge) {
+        ::madvise(p, bytes, MADV_HUGEPAGE);
+      }
+    }
+    block = static_cast<std::byte*>(p);
+  }
+
+  Mmap_storage(const Mmap_storage&) = delete;
+  Mmap_storage& operator=(const Mmap_storage&) = delete;
+
+  ~Mmap_storage() {
+    ::munmap(block, bytes);
+  }
+
+  std::byte* data() const { return block; }
+
+private:
+  std::size_t bytes;
+  std::byte* block;
+};
+
+template<bool Huge = false>
+class Mirrored_storage {
+public:
+  static constexpr std::size_t alignment = 4096;
+  static constexpr bool mirrored = true;
+  static std::size_t granularity() { return Huge ? huge_page_size : page_size(); }
+
+  explicit Mirrored_storage(std::size_t bytes) : bytes{bytes} {
+    if constexpr (Huge) {
+      block = map_twice(MFD_HUGETLB);
+    }
+    if (block == nullptr) {
+      block = map_twice(0);
+      if (block == nullptr) {
+        throw std::system_error{errno, std::generic_category(), "memfd/mmap"};
+      }
+      if constexpr (Huge) {
+        ::madvise(block, 2 * bytes, MADV_HUGEPAGE);
+      }
+    }
+  }
+
+  Mirrored_storage(const Mirrored_storage&) = delete;
+  Mirrored_storage& operator=(const Mirrored_storage&) = delete;
+
+  ~Mirrored_storage() {
+    ::munmap(block, 2 * bytes);
+  }
+
+  std::byte* data() const { return block; }
+
+private:
+  /**
+   * Reserves 2 * bytes of address space, then maps the same memfd
+   * over both halves. Returns nullptr with errno set on failure.
+   */
+  std::byte* map_twice(unsigned int flags) {
+    const int fd = ::memfd_create("my::Mirrored_storage", MFD_CLOEXEC | flags);
+    if (fd < 0) {
+      return nullptr;
+    }
+    void* base = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+      base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (base != MAP_FAILED) {
+      auto* lower = static_cast<std::byte*>(base);
+      if (::mmap(lower, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+        || ::mmap(lower + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        const int error = errno;
+        ::munmap(base, 2 * bytes);
+        errno = error;
+        base = MAP_FAILED;
+      }
+    }
+    const int error = errno;
+    ::close(fd);
+    errno = error;
+    return base == MAP_FAILED ? nullptr : static_cast<std::byte*>(base);
+  }
+
+  std::size_t bytes;
+  std::byte* block{nullptr};
+};
+
+}
@@ -0,0 +1,126 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "shm_ring_buffer.hpp"
+#include <cstdint>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Record {
+  std::uint64_t sequence;
+  double value;
+  char tag[16];
+};
+
+constexpr std::uint64_t count = 200'000;
+
+/**
+ * Pops every record in the child process and exits with 0 if they all
+ * arrived in order.
+ */
+template<typename Buffer>
+[[noreturn]] void consume(Buffer& buffer) {
+  std::uint64_t expected = 0;
+  bool in_order = true;
+  while (expected < count) {
+    if (auto record = buffer.pop()) {
+      in_order = in_order && record->sequence == expected
+        && record->value == static_cast<double>(expected) / 2
+        && record->tag[0] == 'r';
+      expected++;
+    }
+  }
+  ::_exit(in_order ? 0 : 1);
+}
+
+/**
+ * Runs in the child process: attaches to the buffer and consumes it.
+ * The child must not return into the test runner, so it exits with 2
+ * if attaching throws.
+ */
+template<typename Attach>
+[[noreturn]] void attach_and_consume(Attach attach) {
+  try {
+    auto consumer = attach();
+    consume(consumer);
+  } catch (...) {
+  }
+  ::_exit(2);
+}
+
+template<typename Buffer>
+void produce(Buffer& buffer) {
+  for (std::uint64_t i = 0; i < count; i++) {
+    const Record record{i, static_cast<double>(i) / 2, "record"};
+    while (!buffer.push(record)) {}
+  }
+}
+
+int exit_status(pid_t child) {
+  int status = 0;
+  ::waitpid(child, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+}
+
+SCENARIO("Shared-memory ring buffer: named segment") {
+  GIVEN("a buffer created in a named segment") {
+    const std::string name = "/my_shm_ring_buffer_test_" + std::to_string(::getpid());
+    using Buffer = my::Shm_ring_buffer<Record, 64>;
+    auto producer = Buffer::create(name);
+    WHEN("a child process opens the segment by name and pops the records") {
+      const pid_t child = ::fork();
+      REQUIRE(child >= 0);
+      if (child == 0) {
+        attach_and_consume([&name] { return Buffer::open(name); });
+      }
+      produce(producer);
+      const int status = exit_status(child);
+      Buffer::remove(name);
+      THEN("the child gets every record in order") {
+        CHECK(status == 0);
+      }
+    }
+  }
+  GIVEN("a name that does not exist") {
+    WHEN("opening it") {
+      THEN("an exception is thrown") {
+        CHECK_THROWS(my::Shm_ring_buffer<Record, 64>::open("/my_shm_ring_buffer_missing"));
+      }
+    }
+  }
+}
+SCENARIO("Shared-memory ring buffer: anonymous segment") {
+  GIVEN("a buffer created in an anonymous segment") {
+    using Buffer = my::Shm_ring_buffer<Record, 64>;
+    auto producer = Buffer::create_anonymous();
+    WHEN("a child process attaches through the inherited descriptor") {
+      const pid_t child = ::fork();
+      REQUIRE(child >= 0);
+      if (child == 0) {
+        attach_and_consume([&producer] { return Buffer::from_fd(producer.fd()); });
+      }
+      produce(producer);
+      THEN("the child gets every record in order") {
+        CHECK(exit_status(child) == 0);
+      }
+    }
+    WHEN("attaching as a buffer of another type") {
+      THEN("an exception is thrown") {
+        CHECK_THROWS(my::Shm_ring_buffer<Record, 32>::from_fd(producer.fd()));
+      }
+    }
+    WHEN("attaching as a buffer of another layout of the same size") {
+      struct Other {
+        std::uint32_t words[8];
+      };
+      static_assert(sizeof(Other) == sizeof(Record) && alignof(Other) != alignof(Record));
+      THEN("an exception is thrown") {
+        CHECK_THROWS(my::Shm_ring_buffer<Other, 64>::from_fd(producer.fd()));
+      }
+    }
+  }
+}
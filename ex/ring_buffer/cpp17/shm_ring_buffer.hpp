@@ -0,0 +1,258 @@
+/**
+ * @brief Shm_ring_buffer shares a Spsc_ring_buffer between a producer
+ * process and a consumer process on the same machine.
+ *
+ * The buffer lives in a shared memory segment, either a named POSIX
+ * segment (`shm_open()`) or an anonymous memfd whose descriptor is
+ * inherited or passed to the other process. The segment starts with a
+ * small header, followed by the Spsc_ring_buffer itself: its atomic
+ * head and tail on their own cache lines, then the element slots.
+ *
+ * Once both processes have mapped the segment, exchanging an element
+ * is a copy into or out of the shared slots plus an atomic store; there
+ * is no system call on the fast path. This requires:
+ * - T is trivially copyable, since the bytes of an element are read by
+ *   another process;
+ * - the atomics are lock-free, which makes them address-free, so they
+ *   work through two different mappings of the same memory.
+ *
+ * One process creates the segment with `create()` or
+ * `create_anonymous()`, which constructs the buffer; the other attaches
+ * with `open()` or `from_fd()`, which checks the header. The header
+ * holds a fingerprint of the layout: the size and alignment of T, N,
+ * and the size and offsets of the segment. Attaching as a buffer whose
+ * layout differs fails even if the segment sizes match; element types
+ * of the same size and alignment cannot be told apart. Exactly one
+ * process may push and exactly one may pop, as with Spsc_ring_buffer.
+ *
+ * The segment is Linux-specific. Failures throw std::system_error or
+ * std::runtime_error.
+ */
+#pragma once
+
+#include "spsc_ring_buffer.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace my {
+
+/**
+ * Handles to a lock-free FIFO container in shared memory.
+ *
+ * @tparam T The element stored in the buffer.
+ * @tparam N The maximum number of elements in the buffer.
+ */
+template<typename T, std::size_t N>
+class Shm_ring_buffer {
+  static_assert(std::is_trivially_copyable_v<T>,
+    "the elements are read by another process");
+  static_assert(std::atomic<std::size_t>::is_always_lock_free
+    && std::atomic<std::uint64_t>::is_always_lock_free,
+    "the indices must be address-free");
+
+  using Ring = Spsc_ring_buffer<T, N, Cache_aligned>;
+
+  struct Segment {
+    std::atomic<std::uint64_t> magic;
+    std::uint64_t size;
+    std::uint64_t fingerprint;
+    Ring ring;
+  };
+
+  // tells a constructed segment apart from a zero-filled one
+  static constexpr std::uint64_t ready = 0x6d793a3a72696e67;  // "my::ring"
+
+  // an FNV-1a hash of the layout of the segment, the same in every
+  // process that maps it whichever compiler built it
+  static constexpr std::uint64_t layout_fingerprint() {
+    const std::uint64_t layout[] = {
+      sizeof(T), alignof(T), N,
+      sizeof(Segment), alignof(Segment),
+      offsetof(Segment, size), offsetof(Segment, fingerprint), offsetof(Segment, ring),
+    };
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (const auto value : layout) {
+      hash = (hash ^ value) * 0x100000001b3;
+    }
+    return hash;
+  }
+
+public:
+  /**
+   * Creates a named segment and constructs an empty buffer in it. The
+   * name must start with '/' and must not exist yet.
+   */
+  static Shm_ring_buffer create(const std::string& name);
+
+  /**
+   * Attaches to the buffer in a named segment made by `create()`.
+   */
+  static Shm_ring_buffer open(const std::string& name);
+
+  /**
+   * Removes the name of a segment. Processes that have mapped it keep
+   * using it until they unmap it.
+   */
+  static void remove(const std::string& name);
+
+  /**
+   * Creates an anonymous segment and constructs an empty buffer in it.
+   * Other processes get at it through `fd()`, e.g. across fork() or
+   * over a Unix domain socket.
+   */
+  static Shm_ring_buffer create_anonymous();
+
+  /**
+   * Attaches to the buffer in a segment made by `create_anonymous()`.
+   * The handle owns a duplicate of the descriptor.
+   */
+  static Shm_ring_buffer from_fd(int fd);
+
+  Shm_ring_buffer(Shm_ring_buffer&& other) noexcept;
+  Shm_ring_buffer& operator=(Shm_ring_buffer&& other) noexcept;
+  ~Shm_ring_buffer();
+
+  /**
+   * @return The descriptor of the segment.
+   */
+  int fd() const { return descriptor; }
+
+  /**
+   * Copies the argument into the buffer. Only the producer process
+   * may call this method.
+   *
+   * @param T The element to be copied into the buffer.
+   * @return false if the buffer is full, true otherwise.
+   */
+  bool push(const T& e) { return segment->ring.push(e); }
+
+  /**
+   * Returns the oldest element in the buffer. Only the consumer
+   * process may call this method.
+   *
+   * @return The optional value of the oldest element in the
+   * buffer, or `optional.empty`.
+   */
+  std::optional<T> pop() { return segment->ring.pop(); }
+
+  private:
+  Shm_ring_buffer(int fd, bool construct);
+
+  int descriptor;
+  Segment* segment;
+};
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N>::Shm_ring_buffer(int fd, bool construct) : descriptor{fd} {
+  if (construct && ::ftruncate(fd, sizeof(Segment)) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error{error, std::generic_category(), "ftruncate"};
+  }
+  struct stat status{};
+  if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Segment)) {
+    ::close(fd);
+    throw std::runtime_error{"the segment does not hold a Shm_ring_buffer"};
+  }
+  void* p = ::mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error{error, std::generic_category(), "mmap"};
+  }
+  segment = static_cast<Segment*>(p);
+  if (construct) {
+    // the segment is zero-filled, which is not yet a Ring; the magic is
+    // stored last, with release, so that an attaching process that
+    // reads it with acquire also sees the ring and the header
+    std::construct_at(&segment->magic, 0);
+    std::construct_at(&segment->ring);
+    segment->size = sizeof(Segment);
+    segment->fingerprint = layout_fingerprint();
+    segment->magic.store(ready, std::memory_order_release);
+  } else if (segment->magic.load(std::memory_order_acquire) != ready
+    || segment->size != sizeof(Segment)
+    || segment->fingerprint != layout_fingerprint()) {
+    ::munmap(p, sizeof(Segment));
+    ::close(fd);
+    throw std::runtime_error{"the segment does not hold a Shm_ring_buffer of this type"};
+  }
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N> Shm_ring_buffer<T, N>::create(const std::string& name) {
+  const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    throw std::system_error{errno, std::generic_category(), "shm_open " + name};
+  }
+  return Shm_ring_buffer{fd, true};
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N> Shm_ring_buffer<T, N>::open(const std::string& name) {
+  const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+  if (fd < 0) {
+    throw std::system_error{errno, std::generic_category(), "shm_open " + name};
+  }
+  return Shm_ring_buffer{fd, false};
+}
+
+template<typename T, std::size_t N>
+void Shm_ring_buffer<T, N>::remove(const std::string& name) {
+  ::shm_unlink(name.c_str());
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N> Shm_ring_buffer<T, N>::create_anonymous() {
+  const int fd = ::memfd_create("my::Shm_ring_buffer", MFD_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error{errno, std::generic_category(), "memfd_create"};
+  }
+  return Shm_ring_buffer{fd, true};
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N> Shm_ring_buffer<T, N>::from_fd(int fd) {
+  const int copy = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (copy < 0) {
+    throw std::system_error{errno, std::generic_category(), "fcntl"};
+  }
+  return Shm_ring_buffer{copy, false};
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N>::Shm_ring_buffer(Shm_ring_buffer&& other) noexcept
+: descriptor{std::exchange(other.descriptor, -1)},
+  segment{std::exchange(other.segment, nullptr)} {}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N>& Shm_ring_buffer<T, N>::operator=(Shm_ring_buffer&& other) noexcept {
+  std::swap(descriptor, other.descriptor);
+  std::swap(segment, other.segment);
+  return *this;
+}
+
+template<typename T, std::size_t N>
+Shm_ring_buffer<T, N>::~Shm_ring_buffer() {
+  if (segment != nullptr) {
+    ::munmap(segment, sizeof(Segment));
+  }
+  if (descriptor >= 0) {
+    ::close(descriptor);
+  }
+}
+
+}
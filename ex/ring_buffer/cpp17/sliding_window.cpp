@@ -0,0 +1,171 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "sliding_window.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+SCENARIO("Sliding window: use cases") {
+  GIVEN("a three-sample window") {
+    my::Sliding_window<int, 3> window{};
+    WHEN("pushing 1, 2, 3, 4 and 5") {
+      for (int i = 1; i <= 5; i++) {
+        window.push(i);
+      }
+      THEN("the aggregates cover the last three samples") {
+        CHECK(window.sum() == 12);
+        CHECK(window.mean() == 4.0);
+        CHECK(window.min() == 3);
+        CHECK(window.max() == 5);
+        CHECK(window.full());
+      }
+      THEN("the samples stay in the window") {
+        CHECK(window.samples().size() == 3);
+        CHECK(*window.samples().begin() == 3);
+      }
+    }
+  }
+}
+
+SCENARIO("Sliding window: normal cases") {
+  GIVEN("an empty window") {
+    my::Sliding_window<double, 4> window{};
+    THEN("its sum is zero") {
+      CHECK(window.empty());
+      CHECK(window.sum() == 0.0);
+    }
+    WHEN("pushing one sample") {
+      window.push(2.5);
+      THEN("it is the sum, mean, minimum and maximum") {
+        CHECK(window.size() == 1);
+        CHECK(window.sum() == 2.5);
+        CHECK(window.mean() == 2.5);
+        CHECK(window.min() == 2.5);
+        CHECK(window.max() == 2.5);
+      }
+    }
+  }
+  GIVEN("a window whose extreme samples leave it") {
+    my::Sliding_window<int, 3> window{};
+    window.push(9);
+    window.push(-4);
+    window.push(5);
+    WHEN("the maximum leaves the window") {
+      window.push(1);
+      THEN("the next largest sample becomes the maximum") {
+        CHECK(window.max() == 5);
+        CHECK(window.min() == -4);
+      }
+      AND_WHEN("the minimum leaves the window") {
+        window.push(3);
+        THEN("the next smallest sample becomes the minimum") {
+          CHECK(window.min() == 1);
+          CHECK(window.max() == 5);
+        }
+      }
+    }
+  }
+  GIVEN("a window of equal samples") {
+    my::Sliding_window<int, 2> window{};
+    for (int i = 0; i < 5; i++) {
+      window.push(7);
+    }
+    THEN("the extremes are that sample") {
+      CHECK(window.min() == 7);
+      CHECK(window.max() == 7);
+      CHECK(window.sum() == 14);
+    }
+  }
+  GIVEN("a window of unsigned samples") {
+    my::Sliding_window<std::uint8_t, 2> window{};
+    window.push(200);
+    window.push(250);
+    window.push(100);
+    THEN("they are summed without overflowing the sample type") {
+      CHECK(window.sum() == 350);
+    }
+  }
+}
+
+SCENARIO("Sliding window: random samples") {
+  GIVEN("a window of 100 samples") {
+    constexpr std::size_t n = 100;
+    my::Sliding_window<int, n> window{};
+    std::mt19937 random{42};
+    std::uniform_int_distribution<int> sample{-1000, 1000};
+    std::vector<int> all;
+    WHEN("pushing many more samples than fit") {
+      bool agrees = true;
+      for (int i = 0; i < 10'000; i++) {
+        all.push_back(sample(random));
+        window.push(all.back());
+        const auto first = all.end() - static_cast<std::ptrdiff_t>(std::min(all.size(), n));
+        agrees = agrees
+          && window.sum() == std::accumulate(first, all.end(), std::int64_t{0})
+          && window.min() == *std::min_element(first, all.end())
+          && window.max() == *std::max_element(first, all.end());
+      }
+      THEN("the aggregates always agree with a scan of the last samples") {
+        CHECK(agrees);
+      }
+    }
+  }
+}
+
+SCENARIO("Sliding window: drift correction") {
+  GIVEN("a floating-point window that once held a huge sample") {
+    my::Sliding_window<double, 4> window{};
+    window.push(1e17);
+    for (int i = 0; i < 3; i++) {
+      window.push(1.0);
+    }
+    WHEN("the huge sample leaves the window") {
+      window.push(1.0);
+      THEN("the running sum has lost the small samples") {
+        CHECK(window.sum() != 4.0);
+      }
+      AND_WHEN("recomputing the sum") {
+        window.recompute();
+        THEN("it is exact again") {
+          CHECK(window.sum() == 4.0);
+        }
+      }
+      AND_WHEN("pushing until the window has wrapped once more") {
+        for (int i = 0; i < 3; i++) {
+          window.push(1.0);
+        }
+        THEN("the sum has been recomputed without asking") {
+          CHECK(window.sum() == 4.0);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Sliding window: vectorized sums") {
+  GIVEN("spans of every length up to 37") {
+    std::vector<double> doubles(37);
+    std::vector<float> floats(37);
+    std::vector<std::int32_t> ints(37);
+    for (std::size_t i = 0; i < 37; i++) {
+      doubles[i] = 0.5 * static_cast<double>(i);
+      floats[i] = 0.25f * static_cast<float>(i);
+      ints[i] = 1'000'000'000 - static_cast<std::int32_t>(i);
+    }
+    THEN("sum_of() agrees with a plain loop") {
+      bool agrees = true;
+      for (std::size_t n = 0; n <= 37; n++) {
+        agrees = agrees
+          && my::sum_of(std::span<const double>{doubles.data(), n})
+            == std::accumulate(doubles.begin(), doubles.begin() + n, 0.0)
+          && my::sum_of(std::span<const float>{floats.data(), n})
+            == std::accumulate(floats.begin(), floats.begin() + n, 0.0)
+          && my::sum_of(std::span<const std::int32_t>{ints.data(), n})
+            == std::accumulate(ints.begin(), ints.begin() + n, std::int64_t{0});
+      }
+      CHECK(agrees);
+    }
+  }
+}
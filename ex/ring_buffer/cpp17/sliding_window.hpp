@@ -0,0 +1,258 @@
+#pragma once
+
+/**
+ * @brief Sliding_window keeps the sum, mean, minimum and maximum of the
+ * last N samples of an arithmetic type, updated on every push.
+ *
+ * The samples live in a Ring_buffer<T, N> that overwrites the oldest
+ * sample. The aggregates are maintained incrementally rather than by
+ * reading the whole window:
+ * - The sum adds the new sample and subtracts the overwritten one, so
+ *   `sum()` and `mean()` cost O(1). Integral samples are summed in a
+ *   64-bit integer and floating-point samples in (at least) a double.
+ * - The minimum and the maximum are each the front of a monotonic
+ *   deque of (sequence number, sample). A push first drops the front
+ *   if it has left the window, then drops from the back every sample
+ *   that can never be the extreme again because the new one is at
+ *   least as extreme and younger. Every sample enters and leaves each
+ *   deque once, so a push costs amortized O(1).
+ *
+ * Adding and subtracting floating-point samples accumulates rounding
+ * error in the running sum. For floating-point T, the window therefore
+ * recomputes the sum from the samples every N pushes, which keeps the
+ * cost per push O(1) amortized; `recompute()` can also be called at any
+ * time. The recomputation goes through `sum_of()`, which adds the two
+ * contiguous chunks of the ring with AVX2 or SSE2 when the compiler
+ * targets them (e.g. -mavx2) and with a plain loop otherwise.
+ */
+#include "ring_buffer.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace my {
+
+/**
+ * The type in which samples of type T are summed.
+ */
+template<typename T>
+using Window_sum_t = std::conditional_t<std::is_floating_point_v<T>,
+  std::common_type_t<T, double>,
+  std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+/**
+ * Sums the elements, with SIMD instructions for double, float and
+ * 32-bit integers where available.
+ *
+ * @param elements The elements to be summed.
+ * @return The sum in Window_sum_t<T>.
+ */
+template<typename T>
+Window_sum_t<T> sum_of(std::span<const T> elements) {
+  Window_sum_t<T> sum{0};
+  std::size_t i = 0;
+  const auto n = elements.size();
+  [[maybe_unused]] const T* p = elements.data();
+#if defined(__AVX2__)
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    auto lanes = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+      if constexpr (std::is_same_v<T, double>) {
+        lanes = _mm256_add_pd(lanes, _mm256_loadu_pd(p + i));
+      } else {
+        lanes = _mm256_add_pd(lanes, _mm256_cvtps_pd(_mm_loadu_ps(p + i)));
+      }
+    }
+    alignas(32) double partial[4];
+    _mm256_store_pd(partial, lanes);
+    sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  } else if constexpr (std::is_same_v<T, std::int32_t>) {
+    auto lanes = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+      const auto four = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+      lanes = _mm256_add_epi64(lanes, _mm256_cvtepi32_epi64(four));
+    }
+    alignas(32) std::int64_t partial[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(partial), lanes);
+    sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  }
+#elif defined(__SSE2__)
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    auto lanes = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) {
+      if constexpr (std::is_same_v<T, double>) {
+        lanes = _mm_add_pd(lanes, _mm_loadu_pd(p + i));
+      } else {
+        const auto two = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + i));
+        lanes = _mm_add_pd(lanes, _mm_cvtps_pd(_mm_castsi128_ps(two)));
+      }
+    }
+    alignas(16) double partial[2];
+    _mm_store_pd(partial, lanes);
+    sum = partial[0] + partial[1];
+  }
+#endif
+  for (; i < n; i++) {
+    sum += elements[i];
+  }
+  return sum;
+}
+
+/**
+ * A deque of at most N (sequence number, sample) pairs whose samples
+ * are ordered by Compare from front to back.
+ */
+template<typename T, std::size_t N, typename Compare>
+class Monotonic_deque {
+public:
+  /**
+   * Drops the front entries older than the given sequence number.
+   */
+  void expire(std::uint64_t oldest) {
+    while (count > 0 && entries[head].seq < oldest) {
+      head = head + 1 == N ? 0 : head + 1;
+      count--;
+    }
+  }
+
+  /**
+   * Drops the back entries that are not ordered before the sample,
+   * then appends it. There must be fewer than N entries.
+   */
+  void push(std::uint64_t seq, T sample) {
+    while (count > 0 && !Compare{}(entries[back()].sample, sample)) {
+      count--;
+    }
+    count++;
+    entries[back()] = {seq, sample};
+  }
+
+  T front() const { return entries[head].sample; }
+
+private:
+  std::size_t back() const {
+    const auto i = head + count - 1;
+    return i >= N ? i - N : i;
+  }
+
+  struct Entry {
+    std::uint64_t seq;
+    T sample;
+  };
+  std::array<Entry, N> entries;
+  std::size_t head{0};
+  std::size_t count{0};
+};
+
+/**
+ * Running aggregates over the last N samples.
+ *
+ * @tparam T An arithmetic sample type.
+ * @tparam N The number of samples in the window.
+ */
+template<typename T, std::size_t N>
+requires std::is_arithmetic_v<T>
+class Sliding_window {
+public:
+  using sum_type = Window_sum_t<T>;
+  using mean_type = std::common_type_t<sum_type, double>;
+
+  /**
+   * Adds a sample, and drops the oldest one if the window is full.
+   *
+   * @param sample The new sample.
+   */
+  void push(T sample);
+
+  std::size_t size() const { return window.size(); }
+  bool empty() const { return window.empty(); }
+  bool full() const { return window.size() == N; }
+
+  /**
+   * @return The sum of the samples in the window, 0 if it is empty.
+   */
+  sum_type sum() const { return total; }
+
+  /**
+   * The window must not be empty.
+   *
+   * @return The arithmetic mean of the samples in the window.
+   */
+  mean_type mean() const {
+    return static_cast<mean_type>(total) / static_cast<mean_type>(window.size());
+  }
+
+  /**
+   * The window must not be empty.
+   *
+   * @return The smallest sample in the window.
+   */
+  T min() const { return lows.front(); }
+
+  /**
+   * The window must not be empty.
+   *
+   * @return The largest sample in the window.
+   */
+  T max() const { return highs.front(); }
+
+  /**
+   * Recomputes the sum from the samples, discarding the rounding error
+   * accumulated by the running sum.
+   */
+  void recompute();
+
+  /**
+   * @return The samples in the window, oldest first.
+   */
+  const Ring_buffer<T, N>& samples() const { return window; }
+
+private:
+  Ring_buffer<T, N> window;
+  sum_type total{0};
+  std::uint64_t pushes{0};
+  std::size_t until_recompute{N};
+  Monotonic_deque<T, N, std::less<T>> lows;
+  Monotonic_deque<T, N, std::greater<T>> highs;
+};
+
+template<typename T, std::size_t N>
+requires std::is_arithmetic_v<T>
+void Sliding_window<T, N>::push(T sample) {
+  if (full()) {
+    total -= *window.begin();
+  }
+  window.push(sample);
+  total += sample;
+
+  const auto seq = pushes++;
+  if (seq >= N) {
+    // seq - N left the window with this push
+    lows.expire(seq - N + 1);
+    highs.expire(seq - N + 1);
+  }
+  lows.push(seq, sample);
+  highs.push(seq, sample);
+
+  if constexpr (std::is_floating_point_v<T>) {
+    if (--until_recompute == 0) {
+      recompute();
+    }
+  }
+}
+
+template<typename T, std::size_t N>
+requires std::is_arithmetic_v<T>
+void Sliding_window<T, N>::recompute() {
+  const auto [first, second] = window.peek_contiguous();
+  total = sum_of(first) + sum_of(second);
+  until_recompute = N;
+}
+
+}
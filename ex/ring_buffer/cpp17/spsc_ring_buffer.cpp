@@ -0,0 +1,112 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "spsc_ring_buffer.hpp"
+#include <cstddef>
+#include <thread>
+
+// producer state, consumer state and elements each get their own line
+static_assert(sizeof(my::Spsc_ring_buffer<int, 4, my::Cache_aligned>) >= 3 * my::cache_line_size);
+
+SCENARIO("SPSC ring buffer: normal cases") {
+  GIVEN("empty buffer") {
+    my::Spsc_ring_buffer<int, 3> buffer{};
+    WHEN("trying to get the element") {
+      auto element = buffer.pop();
+      THEN("its value should be empty") {
+        CHECK(!element);
+      }
+    }
+  }
+  GIVEN("N elements in the buffer") {
+    my::Spsc_ring_buffer<int, 3> buffer{};
+    CHECK(buffer.push(1));
+    CHECK(buffer.push(2));
+    CHECK(buffer.push(3));
+    WHEN("pushing the N+1th element") {
+      const bool pushed = buffer.push(4);
+      THEN("the push is rejected") {
+        CHECK(!pushed);
+      }
+      THEN("the oldest element is kept") {
+        auto element = buffer.pop();
+        CHECK(element);
+        CHECK(element.value() == 1);
+      }
+    }
+    WHEN("invoking pop() N+1 times") {
+      auto element = buffer.pop();
+      THEN("you get the first recorded element") {
+        CHECK(element);
+        CHECK(element.value() == 1);
+      }
+      element = buffer.pop();
+      THEN("you get the second recorded element") {
+        CHECK(element);
+        CHECK(element.value() == 2);
+      }
+      element = buffer.pop();
+      THEN("you get the third recorded element") {
+        CHECK(element);
+        CHECK(element.value() == 3);
+      }
+      element = buffer.pop();
+      THEN("you get the optional.empty") {
+        CHECK(!element);
+      }
+    }
+  }
+  GIVEN("a buffer that has wrapped around") {
+    my::Spsc_ring_buffer<int, 3> buffer{};
+    for (int i = 0; i < 7; i++) {
+      CHECK(buffer.push(i));
+      CHECK(buffer.pop().value() == i);
+    }
+    WHEN("pushing 7 and 8") {
+      CHECK(buffer.push(7));
+      CHECK(buffer.push(8));
+      THEN("you get them in order") {
+        CHECK(buffer.pop().value() == 7);
+        CHECK(buffer.pop().value() == 8);
+        CHECK(!buffer.pop());
+      }
+    }
+  }
+}
+template<typename Layout>
+void transfer_in_order() {
+  GIVEN("a small buffer shared by two threads") {
+    constexpr std::size_t count = 1'000'000;
+    my::Spsc_ring_buffer<std::size_t, 64, Layout> buffer{};
+    WHEN("the producer pushes 0, 1, ..., count-1") {
+      std::thread producer{[&buffer] {
+        for (std::size_t i = 0; i < count; i++) {
+          while (!buffer.push(i)) {
+            std::this_thread::yield();
+          }
+        }
+      }};
+      std::size_t expected = 0;
+      bool in_order = true;
+      while (expected < count) {
+        if (auto element = buffer.pop()) {
+          in_order = in_order && element.value() == expected;
+          expected++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      producer.join();
+      THEN("the consumer gets every element in order") {
+        CHECK(in_order);
+        CHECK(expected == count);
+        CHECK(!buffer.pop());
+      }
+    }
+  }
+}
+SCENARIO("SPSC ring buffer: one producer and one consumer thread") {
+  transfer_in_order<my::Compact>();
+}
+SCENARIO("SPSC ring buffer: one producer and one consumer thread, cache-aligned") {
+  transfer_in_order<my::Cache_aligned>();
+}
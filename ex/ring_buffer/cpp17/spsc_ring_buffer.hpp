@@ -0,0 +1,157 @@
+/**
+ * @brief Spsc_ring_buffer is a FIFO container that can store at most
+ * N elements of type T, shared by one producer thread and one consumer
+ * thread without a lock.
+ *
+ * Like Ring_buffer, Spsc_ring_buffer stores its elements directly
+ * within the object itself.
+ *
+ * Exactly one thread may call `push()` and exactly one (other) thread
+ * may call `pop()` at the same time. Both methods are wait-free: each
+ * completes in a bounded number of steps regardless of what the other
+ * thread is doing.
+ *
+ * The producer owns `head` and the consumer owns `tail`. Each of them
+ * publishes its own index with a release store and observes the other
+ * index with an acquire load, which also makes the element written
+ * before the store visible to the other side. There is no shared
+ * `count`; the number of elements is `head - tail`.
+ *
+ * Each side also keeps a cached copy of the other side's index, and
+ * reloads the shared atomic only when the cached view says that the
+ * buffer is full (producer) or empty (consumer). While the buffer is
+ * neither, a thread touches only its own variables.
+ *
+ * The Layout parameter chooses where those variables live:
+ * - Compact (default): next to each other, and next to the elements.
+ * - Cache_aligned: the producer's variables, the consumer's variables
+ *   and the elements each start on their own cache line (see
+ *   cache_line.hpp), so a push does not invalidate the line the
+ *   consumer is reading and vice versa.
+ *   This costs up to three cache lines of padding per buffer.
+ *
+ * Unlike Ring_buffer, the producer cannot overwrite the oldest
+ * element, since that element belongs to the consumer. If the buffer
+ * is full, `push()` returns false and leaves the buffer untouched.
+ */
+#pragma once
+
+#include "cache_line.hpp"
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <array>
+#include <type_traits>
+
+namespace my {
+
+/**
+ * Layouts of the producer's and the consumer's state.
+ */
+struct Compact {};
+struct Cache_aligned {};
+
+/**
+ * Lock-free FIFO containers for one producer and one consumer thread.
+ *
+ * @tparam T The element stored in a built-in buffer.
+ * @tparam N The maximum number of elements in the buffer.
+ * @tparam Layout Either Compact or Cache_aligned.
+ */
+template<typename T, std::size_t N, typename Layout = Compact>
+class Spsc_ring_buffer {
+  static_assert(std::is_same_v<Layout, Compact> || std::is_same_v<Layout, Cache_aligned>);
+
+  static constexpr std::size_t alignment = std::is_same_v<Layout, Cache_aligned>
+    ? cache_line_size
+    : alignof(std::atomic<std::size_t>);
+
+public:
+  /**
+   * Copies the argument into a buffer built in the instance.
+   * Only the producer thread may call this method.
+   *
+   * @param T The element to be copied into the buffer.
+   * @return false if the buffer is full, true otherwise.
+   */
+  bool push(const T&);
+
+  /**
+   * Moves the argument into a buffer built in the instance.
+   * Only the producer thread may call this method.
+   *
+   * @param T The element to be moved into the buffer.
+   * @return false if the buffer is full, true otherwise.
+   */
+  bool push(T&&);
+
+  /**
+   * Returns the oldest element in the buffer.
+   * Only the consumer thread may call this method.
+   *
+   * @return The optional value of the oldest element in the
+   * buffer, or `optional.empty`.
+   */
+  std::optional<T> pop();
+
+  private:
+  template<typename U>
+  bool emplace_back(U&&);
+
+  // written by the producer only
+  struct alignas(alignment) Producer {
+    std::atomic<std::size_t> head{0};
+    std::size_t cached_tail{0};
+  };
+  // written by the consumer only
+  struct alignas(alignment) Consumer {
+    std::atomic<std::size_t> tail{0};
+    std::size_t cached_head{0};
+  };
+
+  Producer producer{};
+  Consumer consumer{};
+  alignas(alignment) std::array<T, N> buffer{};
+};
+
+template<typename T, std::size_t N, typename Layout>
+bool Spsc_ring_buffer<T, N, Layout>::push(const T& e) {
+  return emplace_back(e);
+}
+
+template<typename T, std::size_t N, typename Layout>
+bool Spsc_ring_buffer<T, N, Layout>::push(T&& e) {
+  return emplace_back(std::move(e));
+}
+
+template<typename T, std::size_t N, typename Layout>
+template<typename U>
+bool Spsc_ring_buffer<T, N, Layout>::emplace_back(U&& e) {
+  const auto h = producer.head.load(std::memory_order_relaxed);
+  if (h - producer.cached_tail == N) {
+    producer.cached_tail = consumer.tail.load(std::memory_order_acquire);
+    if (h - producer.cached_tail == N) {
+      return false;
+    }
+  }
+  buffer[h % N] = std::forward<U>(e);
+  producer.head.store(h + 1, std::memory_order_release);
+  return true;
+}
+
+template<typename T, std::size_t N, typename Layout>
+std::optional<T> Spsc_ring_buffer<T, N, Layout>::pop() {
+  const auto t = consumer.tail.load(std::memory_order_relaxed);
+  if (t == consumer.cached_head) {
+    consumer.cached_head = producer.head.load(std::memory_order_acquire);
+    if (t == consumer.cached_head) {
+      return {};
+    }
+  }
+  std::optional<T> element{std::move(buffer[t % N])};
+  consumer.tail.store(t + 1, std::memory_order_release);
+
+  return element;
+}
+
+}
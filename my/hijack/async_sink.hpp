@@ -0,0 +1,286 @@
+#pragma once
+
+#include <bounded_queue.hpp>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace my {
+
+/**
+ * A std::streambuf that writes to a file descriptor from a background
+ * thread, so that the threads writing to a hijacked stream such as
+ * std::cout never wait for a slow terminal or file.
+ *
+ * Each writing thread fills its own chunk of up to 248 characters,
+ * found like in Thread_capture through a thread_local cache. A chunk
+ * is handed over when it is full, when a newline is written into it,
+ * or when the stream is flushed, by pushing it into a Bounded_queue.
+ * The background thread pops up to 64 chunks at a time and writes them
+ * with a single writev().
+ *
+ * If the queue is full, the chunk is dropped rather than making the
+ * writing thread wait, and its size is added to dropped_bytes().
+ *
+ * release() and the destructor hand over the chunks that every thread
+ * has not handed over yet, waiting for room in the queue rather than
+ * dropping them, wait until the background thread has written
+ * everything, and stop it. So when a Basic_hijack<Async_sink>
+ * goes out of scope, all output has reached the file descriptor. No
+ * other thread may write to the sink while either runs.
+ *
+ * sample usage:
+ *     {
+ *       my::Basic_hijack<my::Async_sink> hj(std::cout, STDOUT_FILENO);
+ *       std::cout << "Hello\n";
+ *     }
+ *     // "Hello\n" has been written to the standard output
+ */
+class Async_sink : public std::streambuf
+{
+public:
+  struct Chunk {
+    std::uint32_t size{0};
+    std::array<char, 248> bytes;
+  };
+  static constexpr std::size_t queue_capacity = 1024;
+  static constexpr std::size_t batch_size = 64;
+
+  explicit Async_sink(int fd)
+  : fd_{fd}, id_{next_id()}, queue_{std::make_unique<Queue>()},
+    writer_{[this] { drain(); }}
+  {
+  }
+
+  Async_sink(const Async_sink&) = delete;
+  Async_sink& operator=(const Async_sink&) = delete;
+
+  ~Async_sink()
+  {
+    release();
+  }
+
+  /**
+   * Writes out everything and stops the background thread.
+   *
+   * @return The number of bytes dropped because the queue was full.
+   */
+  std::uint64_t release()
+  {
+    if (writer_.joinable()) {
+      {
+        std::lock_guard lock{mutex_};
+        for (auto& l : locals_) {
+          flush(l->chunk);
+        }
+      }
+      stopping_.store(true, std::memory_order_release);
+      signal();
+      writer_.join();
+    }
+    return dropped_bytes();
+  }
+
+  std::uint64_t dropped_bytes() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      const char c = traits_type::to_char_type(ch);
+      xsputn(&c, 1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    auto& chunk = local();
+    bool newline = false;
+    for (auto left = static_cast<std::size_t>(n); left > 0;) {
+      const auto room = chunk.bytes.size() - chunk.size;
+      const auto count = std::min(left, room);
+      std::memcpy(chunk.bytes.data() + chunk.size, s, count);
+      newline = newline || std::memchr(s, '\n', count) != nullptr;
+      chunk.size += static_cast<std::uint32_t>(count);
+      s += count;
+      left -= count;
+      if (chunk.size == chunk.bytes.size()) {
+        hand_over(chunk);
+      }
+    }
+    if (newline) {
+      hand_over(chunk);
+    }
+    return n;
+  }
+
+  int sync() override
+  {
+    hand_over(local());
+    return 0;
+  }
+
+private:
+  using Queue = Bounded_queue<Chunk, queue_capacity>;
+
+  struct Local {
+    std::thread::id thread;
+    Chunk chunk;
+  };
+
+  // the sink that a thread last wrote to, and its chunk there
+  struct Cache {
+    std::uint64_t id;
+    Chunk* chunk;
+  };
+
+  Chunk& local()
+  {
+    if (cache_.id != id_) [[unlikely]] {
+      cache_ = {id_, &attach()};
+    }
+    return *cache_.chunk;
+  }
+
+  Chunk& attach()
+  {
+    const auto thread = std::this_thread::get_id();
+    std::lock_guard lock{mutex_};
+    for (auto& l : locals_) {
+      if (l->thread == thread) {
+        return l->chunk;
+      }
+    }
+    locals_.push_back(std::make_unique<Local>(Local{thread, {}}));
+    return locals_.back()->chunk;
+  }
+
+  void hand_over(Chunk& chunk)
+  {
+    if (chunk.size == 0) {
+      return;
+    }
+    if (queue_->try_push(chunk)) {
+      signal();
+    } else {
+      dropped_.fetch_add(chunk.size, std::memory_order_relaxed);
+    }
+    chunk.size = 0;
+  }
+
+  // hands over the chunk like hand_over(), but waits for the background
+  // thread to make room in the queue instead of dropping the chunk
+  void flush(Chunk& chunk)
+  {
+    if (chunk.size == 0) {
+      return;
+    }
+    while (!queue_->try_push(chunk)) {
+      signal();
+      std::this_thread::yield();
+    }
+    signal();
+    chunk.size = 0;
+  }
+
+  void signal()
+  {
+    signals_.fetch_add(1, std::memory_order_release);
+    signals_.notify_one();
+  }
+
+  // runs on the background thread
+  void drain()
+  {
+    std::vector<Chunk> batch(batch_size);
+    std::array<iovec, batch_size> iov;
+    for (;;) {
+      // a push after this load changes signals_, so the wait below
+      // does not miss it
+      const auto seen = signals_.load(std::memory_order_acquire);
+      // read before popping, so that the chunks handed over by
+      // release() are seen once stopping_ is
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      std::size_t count = 0;
+      while (count < batch_size) {
+        auto chunk = queue_->try_pop();
+        if (!chunk) {
+          break;
+        }
+        batch[count] = *chunk;
+        iov[count] = {batch[count].bytes.data(), batch[count].size};
+        count++;
+      }
+      if (count > 0) {
+        write_all(iov.data(), static_cast<int>(count));
+      } else if (stopping) {
+        return;
+      } else {
+        signals_.wait(seen, std::memory_order_acquire);
+      }
+    }
+  }
+
+  void write_all(iovec* iov, int count)
+  {
+    while (count > 0) {
+      const auto written = ::writev(fd_, iov, count);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        // the output is lost, like a dropped chunk
+        for (int i = 0; i < count; i++) {
+          dropped_.fetch_add(iov[i].iov_len, std::memory_order_relaxed);
+        }
+        return;
+      }
+      // skip what was written, which may end in the middle of a chunk
+      auto left = static_cast<std::size_t>(written);
+      while (count > 0 && left >= iov->iov_len) {
+        left -= iov->iov_len;
+        iov++;
+        count--;
+      }
+      if (count > 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+        iov->iov_len -= left;
+      }
+    }
+  }
+
+  // ids are never reused, so a stale cache never matches a new sink
+  static std::uint64_t next_id()
+  {
+    static std::atomic<std::uint64_t> last{0};
+    return last.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static inline thread_local Cache cache_{0, nullptr};
+
+  const int fd_;
+  const std::uint64_t id_;
+  std::unique_ptr<Queue> queue_;
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint32_t> signals_{0};
+  std::atomic<bool> stopping_{false};
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Local>> locals_;
+  std::thread writer_;
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace my {
+
+/**
+ * A bounded lock-free FIFO queue of at most N elements, shared by any
+ * number of producer and consumer threads, that Async_sink hands its
+ * chunks over through.
+ *
+ * It is Dmitry Vyukov's bounded MPMC queue, the algorithm of
+ * Mpmc_queue<T, N, Reject> in ex/ring_buffer/cpp17, kept here so that
+ * my/hijack stays header-only and needs no other include path. Every
+ * slot has a sequence number next to the element. A producer that has
+ * claimed position `pos` may write the slot only when its sequence
+ * equals `pos`, and publishes the element by storing `pos + 1`. A
+ * consumer that has claimed `pos` may read the slot only when its
+ * sequence equals `pos + 1`, and frees it for the next lap by storing
+ * `pos + N`.
+ *
+ * sample usage:
+ *     my::Bounded_queue<int, 16> queue;
+ *     queue.try_push(1);
+ *     std::optional<int> one = queue.try_pop();
+ */
+template <typename T, std::size_t N>
+class Bounded_queue
+{
+public:
+  Bounded_queue()
+  {
+    for (std::size_t i = 0; i < N; i++) {
+      buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  Bounded_queue(const Bounded_queue&) = delete;
+  Bounded_queue& operator=(const Bounded_queue&) = delete;
+
+  /**
+   * Copies the argument into the queue.
+   *
+   * @return false if the queue is full, and then it is left untouched.
+   */
+  bool try_push(const T& e)
+  {
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &buffer_[pos % N];
+      const auto seq = slot->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // the slot still holds the element from the previous lap
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = e;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Moves out the oldest element, or returns an empty optional if the
+   * queue is empty.
+   */
+  std::optional<T> try_pop()
+  {
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &buffer_[pos % N];
+      const auto seq = slot->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // no producer has published this position yet
+        return {};
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    std::optional<T> element{std::move(slot->value)};
+    slot->sequence.store(pos + N, std::memory_order_release);
+    return element;
+  }
+
+private:
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    T value{};
+  };
+
+  std::array<Slot, N> buffer_{};
+  std::atomic<std::size_t> enqueue_pos_{0};
+  std::atomic<std::size_t> dequeue_pos_{0};
+};
+
+}
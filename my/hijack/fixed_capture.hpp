@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace my {
+
+/**
+ * A std::streambuf that writes into a fixed buffer supplied by the
+ * caller, e.g. a local array or a block from an arena. It never
+ * allocates, and release() returns a std::string_view over what has
+ * been written, so nothing is copied either.
+ *
+ * Output that does not fit is dropped, the stream it was written to
+ * goes bad, and truncated() returns true.
+ *
+ * sample usage:
+ *     char storage[4096];
+ *     my::Basic_hijack<my::Span_capture> hj(std::cout, storage);
+ *     std::cout << "Hello";
+ *     std::string_view captured = hj.release();
+ */
+class Span_capture : public std::streambuf
+{
+public:
+  explicit Span_capture(std::span<char> storage)
+  {
+    setp(storage.data(), storage.data() + storage.size());
+  }
+
+  Span_capture(const Span_capture&) = delete;
+  Span_capture& operator=(const Span_capture&) = delete;
+
+  std::string_view view() const
+  {
+    return {pbase(), static_cast<std::size_t>(pptr() - pbase())};
+  }
+
+  std::string_view release()
+  {
+    return view();
+  }
+
+  bool truncated() const
+  {
+    return truncated_;
+  }
+
+protected:
+  Span_capture() = default;
+
+  int_type overflow(int_type ch) override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    truncated_ = true;
+    return traits_type::eof();
+  }
+
+  // copies the whole run at once instead of one sputc() per character
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    const auto room = epptr() - pptr();
+    if (n > room) {
+      truncated_ = true;
+      n = room;
+    }
+    if (n <= 0) {
+      return 0;
+    }
+    std::memcpy(pptr(), s, static_cast<std::size_t>(n));
+    // pbump() takes an int
+    for (auto left = n; left > 0; left -= std::numeric_limits<int>::max()) {
+      pbump(static_cast<int>(std::min<std::streamsize>(left, std::numeric_limits<int>::max())));
+    }
+    return n;
+  }
+
+private:
+  bool truncated_{false};
+};
+
+/**
+ * A Span_capture over a std::string that it allocates once, at full
+ * capacity, when constructed. release() moves the string out, cut to
+ * what has been written, so the output is neither reallocated while
+ * it is captured nor copied when it is released.
+ *
+ * sample usage:
+ *     my::Basic_hijack<my::String_capture> hj(std::cout, 1 << 20);
+ *     std::cout << "Hello";
+ *     std::string captured = hj.release();
+ */
+class String_capture : public Span_capture
+{
+public:
+  explicit String_capture(std::size_t capacity)
+  {
+#ifdef __cpp_lib_string_resize_and_overwrite
+    // the characters are written by the stream, so need not be zeroed
+    storage_.resize_and_overwrite(capacity, [](char*, std::size_t n) { return n; });
+#else
+    storage_.resize(capacity);
+#endif
+    setp(storage_.data(), storage_.data() + storage_.size());
+  }
+
+  std::string release()
+  {
+    storage_.resize(static_cast<std::size_t>(pptr() - pbase()));
+    setp(nullptr, nullptr);
+    return std::move(storage_);
+  }
+
+private:
+  std::string storage_;
+};
+
+}
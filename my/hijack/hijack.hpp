@@ -2,6 +2,8 @@
 
 #include <ostream>
 #include <sstream>
+#include <streambuf>
+#include <utility>
 
 namespace my {
 
@@ -43,4 +45,58 @@ private:
   std::ostringstream redirected_ostream_{};
 };
 
+/**
+ * Redirect a stream characters from a given std::ostream to a
+ * streambuf of type Buffer built in the Basic_hijack, until released
+ * or destructed. Buffer is constructed from the arguments following
+ * the stream, and the release() method returns whatever
+ * Buffer::release() returns.
+ *
+ * Unlike Hijack, which copies its std::ostringstream into a new
+ * std::string, a Buffer such as Span_capture or String_capture (see
+ * fixed_capture.hpp) hands back its storage without a copy.
+ *
+ * sample usage:
+ *     char storage[256];
+ *     my::Basic_hijack<my::Span_capture> hj(std::cout, storage);
+ *     std::cout << "Hello";
+ *     std::string_view hello = hj.release();
+ */
+template <typename Buffer>
+class Basic_hijack
+{
+public:
+  template <typename... Args>
+  explicit Basic_hijack(std::ostream &os, Args&&... args)
+  : original_ostream_{os}, original_rdbuf_{os.rdbuf()},
+    buffer_(std::forward<Args>(args)...)
+  {
+    original_ostream_.rdbuf(&buffer_);
+  }
+
+  Basic_hijack(const Basic_hijack&) = delete;
+  Basic_hijack& operator=(const Basic_hijack&) = delete;
+
+  ~Basic_hijack()
+  {
+    original_ostream_.rdbuf(original_rdbuf_);
+  }
+
+  decltype(auto) release()
+  {
+    original_ostream_.rdbuf(original_rdbuf_);
+    return buffer_.release();
+  }
+
+  Buffer& buffer()
+  {
+    return buffer_;
+  }
+
+private:
+  std::ostream &original_ostream_;
+  std::streambuf* original_rdbuf_;
+  Buffer buffer_;
+};
+
 }
@@ -0,0 +1,115 @@
+/**
+ * Measures the cost per line of capturing formatted output:
+ * - Hijack/ostringstream: Hijack, capturing into its std::ostringstream.
+ * - Hijack/naive_tee: a tee with no buffer of its own, which passes
+ *   every character and every run both to an std::ostringstream and to
+ *   the original streambuf.
+ * - Basic_hijack/Tee_capture: Tee_capture, which formats into one buffer
+ *   and forwards it in batches.
+ * - Basic_hijack/String_capture: String_capture, for reference.
+ * Each iteration writes one line of strings and integers, and the
+ * output is released every 10'000 lines. The original streambuf counts
+ * what it receives and discards it, so that no I/O is measured.
+ *
+ * Uses the harness of the ring buffer benchmarks, which writes JSON.
+ * Build with optimization and run, e.g.
+ *     clang++ -std=c++23 -O2 -DNDEBUG -I. -I../../ex/ring_buffer/cpp17 hijack_bench.cpp -o hijack_bench
+ *     ./hijack_bench
+ */
+#include <bench.hpp>
+#include <fixed_capture.hpp>
+#include <hijack.hpp>
+#include <tee_capture.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+namespace {
+
+constexpr std::uint64_t lines_per_release = 10'000;
+
+// discards everything, but not so that the compiler can tell
+struct Null_buf : std::streambuf {
+  std::uint64_t received = 0;
+
+  int_type overflow(int_type ch) override {
+    received++;
+    return ch;
+  }
+  std::streamsize xsputn(const char*, std::streamsize n) override {
+    received += static_cast<std::uint64_t>(n);
+    return n;
+  }
+};
+
+struct Naive_tee : std::streambuf {
+  explicit Naive_tee(std::streambuf* forward) : forward{forward} {}
+
+  std::string release() { return captured.str(); }
+
+  int_type overflow(int_type ch) override {
+    captured.rdbuf()->sputc(traits_type::to_char_type(ch));
+    return forward->sputc(traits_type::to_char_type(ch));
+  }
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    captured.rdbuf()->sputn(s, n);
+    return forward->sputn(s, n);
+  }
+
+  std::streambuf* forward;
+  std::ostringstream captured;
+};
+
+void write_line(std::ostream& os, std::uint64_t i) {
+  os << "line " << i << " of " << lines_per_release << '\n';
+}
+
+/**
+ * Writes the lines through a hijacked stream, making a new Hijack from
+ * make(os) for every lines_per_release lines.
+ */
+template<typename Make>
+void capture(std::uint64_t iterations, Make make) {
+  Null_buf original;
+  std::ostream os(&original);
+  for (std::uint64_t i = 0; i < iterations;) {
+    auto hijack = make(os);
+    for (const auto end = std::min(iterations, i + lines_per_release); i < end; i++) {
+      write_line(os, i);
+    }
+    auto captured = hijack->release();
+    my::bench::do_not_optimize(captured);
+  }
+  my::bench::do_not_optimize(original.received);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+  my::bench::Suite suite;
+
+  suite.add({"Hijack/ostringstream"}, [](std::uint64_t iterations) {
+    capture(iterations, [](std::ostream& os) { return std::make_unique<my::Hijack>(os); });
+  });
+  suite.add({"Hijack/naive_tee"}, [](std::uint64_t iterations) {
+    capture(iterations, [](std::ostream& os) {
+      return std::make_unique<my::Basic_hijack<Naive_tee>>(os, os.rdbuf());
+    });
+  });
+  suite.add({"Basic_hijack/Tee_capture"}, [](std::uint64_t iterations) {
+    capture(iterations, [](std::ostream& os) {
+      return std::make_unique<my::Basic_hijack<my::Tee_capture>>(os, os.rdbuf());
+    });
+  });
+  suite.add({"Basic_hijack/String_capture"}, [](std::uint64_t iterations) {
+    capture(iterations, [](std::ostream& os) {
+      return std::make_unique<my::Basic_hijack<my::String_capture>>(os, 1 << 20);
+    });
+  });
+
+  return suite.main(argc, argv);
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace my {
+
+/**
+ * A read-only mapping of a captured file, returned by
+ * Mmap_capture::release(). It owns the mapping and the file
+ * descriptor, and unmaps and closes them when destructed.
+ */
+class Mapped_view
+{
+public:
+  Mapped_view() = default;
+
+  Mapped_view(int fd, const char* data, std::size_t size, std::size_t mapped)
+  : fd_{fd}, data_{data}, size_{size}, mapped_{mapped}
+  {
+  }
+
+  Mapped_view(Mapped_view&& other) noexcept
+  : fd_{std::exchange(other.fd_, -1)},
+    data_{std::exchange(other.data_, nullptr)},
+    size_{std::exchange(other.size_, 0)},
+    mapped_{std::exchange(other.mapped_, 0)}
+  {
+  }
+
+  Mapped_view& operator=(Mapped_view&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      fd_ = std::exchange(other.fd_, -1);
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      mapped_ = std::exchange(other.mapped_, 0);
+    }
+    return *this;
+  }
+
+  ~Mapped_view()
+  {
+    reset();
+  }
+
+  std::string_view view() const
+  {
+    return {data_, size_};
+  }
+
+  const char* data() const
+  {
+    return data_;
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  // the unlinked file, e.g. to sendfile() it somewhere
+  int fd() const
+  {
+    return fd_;
+  }
+
+private:
+  void reset()
+  {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), mapped_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    data_ = nullptr;
+    fd_ = -1;
+  }
+
+  int fd_{-1};
+  const char* data_{nullptr};
+  std::size_t size_{0};
+  std::size_t mapped_{0};
+};
+
+/**
+ * A std::streambuf that writes into a shared mapping of a temporary
+ * file, so that captures of many gigabytes live in the page cache and
+ * can be paged out instead of filling the heap.
+ *
+ * The file is created in $TMPDIR (or /tmp) and unlinked at once, so
+ * it disappears with its last descriptor. The mapping is the put area.
+ * When it is full, the file is extended with ftruncate() to twice its
+ * size and the mapping with mremap(), which moves no data; other
+ * systems than Linux unmap and map it again.
+ *
+ * release() cuts the file to what has been written, makes the mapping
+ * read-only and returns it as a Mapped_view, so comparing a capture
+ * against a golden file needs neither a copy nor a read().
+ *
+ * The constructor throws std::system_error if the file cannot be
+ * created. If it cannot be extended later, the stream goes bad.
+ *
+ * sample usage:
+ *     my::Basic_hijack<my::Mmap_capture> hj(std::cout);
+ *     std::cout << "Hello";
+ *     my::Mapped_view captured = hj.release();
+ *     std::string_view hello = captured.view();
+ */
+class Mmap_capture : public std::streambuf
+{
+public:
+  explicit Mmap_capture(std::size_t capacity = std::size_t{1} << 20)
+  {
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string{dir != nullptr && *dir != '\0' ? dir : "/tmp"} + "/hijack-XXXXXX";
+    fd_ = ::mkstemp(path.data());
+    if (fd_ < 0) {
+      throw std::system_error{errno, std::generic_category(), "mkstemp"};
+    }
+    ::unlink(path.c_str());
+    try {
+      grow(capacity);
+    } catch (...) {
+      ::close(fd_);
+      throw;
+    }
+  }
+
+  Mmap_capture(const Mmap_capture&) = delete;
+  Mmap_capture& operator=(const Mmap_capture&) = delete;
+
+  ~Mmap_capture()
+  {
+    if (pbase() != nullptr) {
+      ::munmap(pbase(), capacity_);
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  std::string_view view() const
+  {
+    return {pbase(), written()};
+  }
+
+  Mapped_view release()
+  {
+    if (fd_ < 0) {
+      return {};
+    }
+    const auto size = written();
+    ::ftruncate(fd_, static_cast<off_t>(size));
+    ::mprotect(pbase(), capacity_, PROT_READ);
+    Mapped_view view{std::exchange(fd_, -1), pbase(), size, std::exchange(capacity_, 0)};
+    setp(nullptr, nullptr);
+    return view;
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    if (fd_ < 0 || !try_grow(2 * capacity_)) {
+      return traits_type::eof();
+    }
+    *pptr() = traits_type::to_char_type(ch);
+    advance(1);
+    return ch;
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    const auto count = static_cast<std::size_t>(n);
+    if (count > static_cast<std::size_t>(epptr() - pptr())) {
+      if (fd_ < 0 || !try_grow(std::max(2 * capacity_, written() + count))) {
+        return 0;
+      }
+    }
+    std::memcpy(pptr(), s, count);
+    advance(count);
+    return n;
+  }
+
+private:
+  std::size_t written() const
+  {
+    return static_cast<std::size_t>(pptr() - pbase());
+  }
+
+  bool try_grow(std::size_t capacity)
+  {
+    try {
+      grow(capacity);
+      return true;
+    } catch (const std::system_error&) {
+      return false;
+    }
+  }
+
+  // extends the file and the mapping, keeping what has been written
+  void grow(std::size_t capacity)
+  {
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    capacity = (std::max<std::size_t>(capacity, 1) + page - 1) / page * page;
+    if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+      throw std::system_error{errno, std::generic_category(), "ftruncate"};
+    }
+    const auto size = written();
+    void* p;
+    if (pbase() == nullptr) {
+      p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    } else {
+#ifdef __linux__
+      p = ::mremap(pbase(), capacity_, capacity, MREMAP_MAYMOVE);
+#else
+      ::munmap(pbase(), capacity_);
+      setp(nullptr, nullptr);
+      p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+#endif
+    }
+    if (p == MAP_FAILED) {
+      throw std::system_error{errno, std::generic_category(), "mmap"};
+    }
+    capacity_ = capacity;
+    setp(static_cast<char*>(p), static_cast<char*>(p) + capacity);
+    advance(size);
+  }
+
+  // pbump() takes an int
+  void advance(std::size_t n)
+  {
+    while (n > 0) {
+      const auto step = std::min<std::size_t>(n, std::numeric_limits<int>::max());
+      pbump(static_cast<int>(step));
+      n -= step;
+    }
+  }
+
+  int fd_{-1};
+  std::size_t capacity_{0};
+};
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace my {
+
+/**
+ * A std::streambuf that both captures what is written to it and
+ * forwards it to another streambuf, typically the one a Basic_hijack
+ * has taken out of the stream.
+ *
+ * The characters are formatted once, into the capture buffer, which
+ * is also the put area. What has not been forwarded yet is passed on
+ * in a single sputn() when the put area is full, when the stream is
+ * flushed (e.g. by std::endl) and on release(), rather than one
+ * character at a time. Forwarded output therefore appears when the
+ * stream is flushed, like that of any buffered stream.
+ *
+ * When the put area is full, the buffer doubles, keeping what has
+ * been captured so far. release() moves it out, cut to what has been
+ * written. What has not been forwarded when the Tee_capture is
+ * destructed, e.g. when a hijack ends without release(), is forwarded
+ * then.
+ *
+ * sample usage:
+ *     my::Basic_hijack<my::Tee_capture> hj(std::cout, std::cout.rdbuf());
+ *     std::cout << "Hello" << std::endl;
+ *     // "Hello\n" has been printed
+ *     std::string hello = hj.release();
+ */
+class Tee_capture : public std::streambuf
+{
+public:
+  explicit Tee_capture(std::streambuf* forward, std::size_t capacity = 4096)
+  : forward_{forward}
+  {
+    grow(std::max<std::size_t>(capacity, 1));
+  }
+
+  Tee_capture(const Tee_capture&) = delete;
+  Tee_capture& operator=(const Tee_capture&) = delete;
+
+  ~Tee_capture()
+  {
+    forward_pending();
+    forward_->pubsync();
+  }
+
+  std::string_view view() const
+  {
+    return {pbase(), written()};
+  }
+
+  std::string release()
+  {
+    forward_pending();
+    forward_->pubsync();
+    text_.resize(written());
+    setp(nullptr, nullptr);
+    forwarded_ = 0;
+    return std::move(text_);
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    forward_pending();
+    grow(2 * text_.size());
+    *pptr() = traits_type::to_char_type(ch);
+    advance(1);
+    return ch;
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    const auto count = static_cast<std::size_t>(n);
+    if (count > static_cast<std::size_t>(epptr() - pptr())) {
+      forward_pending();
+      grow(std::max(2 * text_.size(), written() + count));
+    }
+    std::memcpy(pptr(), s, count);
+    advance(count);
+    return n;
+  }
+
+  int sync() override
+  {
+    forward_pending();
+    return forward_->pubsync();
+  }
+
+private:
+  std::size_t written() const
+  {
+    return static_cast<std::size_t>(pptr() - pbase());
+  }
+
+  void forward_pending()
+  {
+    const auto size = written();
+    if (size > forwarded_) {
+      forward_->sputn(text_.data() + forwarded_, static_cast<std::streamsize>(size - forwarded_));
+      forwarded_ = size;
+    }
+  }
+
+  // keeps what has been written, and makes the rest the put area
+  void grow(std::size_t capacity)
+  {
+    const auto size = written();
+#ifdef __cpp_lib_string_resize_and_overwrite
+    text_.resize_and_overwrite(capacity, [](char*, std::size_t n) { return n; });
+#else
+    text_.resize(capacity);
+#endif
+    setp(text_.data(), text_.data() + text_.size());
+    advance(size);
+  }
+
+  // pbump() takes an int
+  void advance(std::size_t n)
+  {
+    while (n > 0) {
+      const auto step = std::min<std::size_t>(n, std::numeric_limits<int>::max());
+      pbump(static_cast<int>(step));
+      n -= step;
+    }
+  }
+
+  std::streambuf* forward_;
+  std::string text_;
+  std::size_t forwarded_{0};
+};
+
+}
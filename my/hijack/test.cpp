@@ -1,7 +1,20 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
+#include <async_sink.hpp>
+#include <fixed_capture.hpp>
 #include <hijack.hpp>
+#include <mmap_capture.hpp>
+#include <tee_capture.hpp>
+#include <thread_capture.hpp>
+#include <cstdio>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
 
 template <typename T>
 struct Lifetime {
@@ -130,3 +143,286 @@ TEST_CASE("move assigned") {
   };
   CHECK(message == expected);
 }
+TEST_CASE("captured into a caller's buffer") {
+  char storage[64];
+  my::Basic_hijack<my::Span_capture> out(std::cout, storage);
+  {
+    Lifetime life{1};
+  }
+  const std::string_view message{out.release()};
+  CHECK(message == "value constructed with 1\ndestructing 1\n");
+  CHECK(message.data() == storage);
+  CHECK(!out.buffer().truncated());
+}
+TEST_CASE("captured into a buffer that is too small") {
+  char storage[16];
+  my::Basic_hijack<my::Span_capture> out(std::cout, storage);
+  std::cout << "value constructed with " << 1 << '\n';
+  CHECK(!std::cout.good());
+  std::cout.clear();
+  const std::string_view message{out.release()};
+  CHECK(message == "value constructe");
+  CHECK(out.buffer().truncated());
+}
+TEST_CASE("captured into a string allocated once") {
+  my::Basic_hijack<my::String_capture> out(std::cout, 1024);
+  const char* storage = out.buffer().view().data();
+  {
+    Lifetime life{1};
+  }
+  const std::string message{out.release()};
+  CHECK(message == "value constructed with 1\ndestructing 1\n");
+  CHECK(message.data() == storage);
+}
+TEST_CASE("released when destructed") {
+  std::streambuf* original = std::cout.rdbuf();
+  {
+    char storage[16];
+    my::Basic_hijack<my::Span_capture> out(std::cout, storage);
+    CHECK(std::cout.rdbuf() != original);
+  }
+  CHECK(std::cout.rdbuf() == original);
+}
+TEST_CASE("captured per thread") {
+  constexpr int threads = 4;
+  constexpr int lines = 1000;
+  my::Basic_hijack<my::Thread_capture> out(std::cout);
+  std::vector<std::string> taken(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&out, &taken, t] {
+      for (int i = 0; i < lines; i++) {
+        std::cout.write("thread ", 7).put(static_cast<char>('0' + t)).put('\n');
+      }
+      taken[t] = out.buffer().take();
+      std::cout.write("done\n", 5);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  std::string expected;
+  for (int i = 0; i < lines; i++) {
+    expected += "thread 0\n";
+  }
+  CHECK(taken[0] == expected);
+  bool apart = true;
+  for (int t = 0; t < threads; t++) {
+    apart = apart && taken[t].size() == expected.size()
+      && taken[t].find_first_not_of(std::string{"thread \n"} + static_cast<char>('0' + t)) == std::string::npos;
+  }
+  CHECK(apart);
+  CHECK(out.release() == "done\ndone\ndone\ndone\n");
+}
+TEST_CASE("captured per thread, taken twice") {
+  my::Basic_hijack<my::Thread_capture> out(std::cout);
+  std::cout << "first";
+  CHECK(out.buffer().take() == "first");
+  std::cout << "second";
+  CHECK(out.buffer().take() == "second");
+  CHECK(out.buffer().release().empty());
+}
+TEST_CASE("captured per thread, merged on release") {
+  my::Basic_hijack<my::Thread_capture> out(std::cout);
+  std::cout << "main " << 1 << '\n';
+  std::thread worker([] {
+    std::cout << "worker " << 2 << '\n';
+  });
+  worker.join();
+  std::cout << "main " << 3 << '\n';
+  CHECK(out.release() == "main 1\nmain 3\nworker 2\n");
+}
+namespace {
+
+std::string read_all(int fd) {
+  std::string text;
+  char chunk[4096];
+  ::lseek(fd, 0, SEEK_SET);
+  for (ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0;) {
+    text.append(chunk, static_cast<std::size_t>(n));
+  }
+  return text;
+}
+
+}
+
+TEST_CASE("written asynchronously") {
+  std::FILE* file = std::tmpfile();
+  {
+    my::Basic_hijack<my::Async_sink> out(std::cout, ::fileno(file));
+    {
+      Lifetime life{1};
+    }
+    std::cout << "no newline";
+  }
+  CHECK(read_all(::fileno(file)) == "value constructed with 1\ndestructing 1\nno newline");
+  std::fclose(file);
+}
+TEST_CASE("written asynchronously by many threads") {
+  constexpr int threads = 4;
+  constexpr int lines = 2000;
+  std::FILE* file = std::tmpfile();
+  std::uint64_t dropped = 0;
+  {
+    my::Basic_hijack<my::Async_sink> out(std::cout, ::fileno(file));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([t] {
+        for (int i = 0; i < lines; i++) {
+          std::cout << "thread " << t << " line " << i << '\n';
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    dropped = out.release();
+  }
+  std::istringstream text{read_all(::fileno(file))};
+  std::vector<int> next(threads, 0);
+  bool in_order = true;
+  std::size_t bytes = 0;
+  for (std::string line; std::getline(text, line);) {
+    int t = -1;
+    int i = -1;
+    in_order = in_order && std::sscanf(line.c_str(), "thread %d line %d", &t, &i) == 2
+      && t >= 0 && t < threads && i >= next[t];
+    if (in_order) {
+      next[t] = i + 1;
+    }
+    bytes += line.size() + 1;
+  }
+  CHECK(in_order);
+  std::size_t expected = 0;
+  for (int t = 0; t < threads; t++) {
+    for (int i = 0; i < lines; i++) {
+      expected += ("thread " + std::to_string(t) + " line " + std::to_string(i) + "\n").size();
+    }
+  }
+  CHECK(bytes + dropped == expected);
+  std::fclose(file);
+}
+TEST_CASE("dropped when the writer cannot keep up") {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  const std::string line(200, 'x');
+  constexpr int lines = 4 * my::Async_sink::queue_capacity;
+  std::string received;
+  std::uint64_t dropped = 0;
+  {
+    my::Basic_hijack<my::Async_sink> out(std::cout, fds[1]);
+    // nobody reads the pipe yet, so the writer blocks once it is full
+    for (int i = 0; i < lines; i++) {
+      std::cout << line << '\n';
+    }
+    CHECK(out.buffer().dropped_bytes() > 0);
+    // still pending when the queue is full, so release() must wait
+    std::cout << "tail";
+    std::thread reader([&received, fd = fds[0]] { received = read_all(fd); });
+    dropped = out.release();
+    ::close(fds[1]);
+    reader.join();
+  }
+  CHECK(dropped > 0);
+  CHECK(received.ends_with("tail"));
+  CHECK(received.size() + dropped == lines * (line.size() + 1) + 4);
+  ::close(fds[0]);
+}
+namespace {
+
+// records every call that reaches it
+struct Recording_buf : std::streambuf {
+  std::string text;
+  int calls = 0;
+  int syncs = 0;
+
+  int_type overflow(int_type ch) override {
+    calls++;
+    text.push_back(traits_type::to_char_type(ch));
+    return ch;
+  }
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    calls++;
+    text.append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+  int sync() override {
+    syncs++;
+    return 0;
+  }
+};
+
+}
+
+TEST_CASE("captured and forwarded") {
+  Recording_buf forward;
+  std::ostream os(&forward);
+  my::Basic_hijack<my::Tee_capture> out(os, os.rdbuf());
+  os << "value constructed with " << 1 << '\n';
+  CHECK(forward.calls == 0);
+  os << "destructing " << 1 << std::endl;
+  CHECK(forward.text == "value constructed with 1\ndestructing 1\n");
+  CHECK(forward.calls == 1);
+  CHECK(forward.syncs == 1);
+  os << "unflushed";
+  const std::string message{out.release()};
+  CHECK(message == "value constructed with 1\ndestructing 1\nunflushed");
+  CHECK(forward.text == message);
+  CHECK(forward.calls == 2);
+}
+TEST_CASE("forwarded when the hijack ends unflushed") {
+  Recording_buf forward;
+  std::ostream os(&forward);
+  {
+    my::Basic_hijack<my::Tee_capture> out(os, os.rdbuf());
+    os << "hello, never flushed\n";
+    CHECK(forward.text.empty());
+  }
+  CHECK(os.rdbuf() == &forward);
+  CHECK(forward.text == "hello, never flushed\n");
+  CHECK(forward.syncs == 1);
+}
+TEST_CASE("captured and forwarded beyond the initial capacity") {
+  Recording_buf forward;
+  std::ostream os(&forward);
+  my::Basic_hijack<my::Tee_capture> out(os, os.rdbuf(), 8);
+  std::string expected;
+  for (int i = 0; i < 1000; i++) {
+    os << i << ' ';
+    expected += std::to_string(i) + ' ';
+  }
+  os << std::string(5000, 'x');
+  expected += std::string(5000, 'x');
+  const std::string message{out.release()};
+  CHECK(message == expected);
+  CHECK(forward.text == expected);
+  // one call per doubling rather than per character
+  CHECK(forward.calls < 20);
+}
+TEST_CASE("captured into a mapped file") {
+  my::Basic_hijack<my::Mmap_capture> out(std::cout);
+  {
+    Lifetime life{1};
+  }
+  const my::Mapped_view message{out.release()};
+  CHECK(message.view() == "value constructed with 1\ndestructing 1\n");
+  struct stat st;
+  REQUIRE(::fstat(message.fd(), &st) == 0);
+  CHECK(static_cast<std::size_t>(st.st_size) == message.size());
+}
+TEST_CASE("captured into a mapped file that grows") {
+  my::Basic_hijack<my::Mmap_capture> out(std::cout, 1);
+  std::string expected;
+  for (int i = 0; i < 20'000; i++) {
+    std::cout << "line " << i << '\n';
+    expected += "line " + std::to_string(i) + '\n';
+  }
+  std::cout << std::string(100'000, 'x');
+  expected += std::string(100'000, 'x');
+  CHECK(std::cout.good());
+  my::Mapped_view message{out.release()};
+  CHECK(message.view() == expected);
+  my::Mapped_view moved{std::move(message)};
+  CHECK(moved.size() == expected.size());
+  CHECK(message.view().empty());
+}
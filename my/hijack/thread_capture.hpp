@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace my {
+
+/**
+ * A std::streambuf that keeps what each thread writes to it apart, so
+ * that threads running concurrently can share one hijacked stream,
+ * such as std::cout, without interleaving or racing.
+ *
+ * Each thread appends to its own std::string, which it finds through
+ * a thread_local cache of (capture id, string). Only the first write
+ * of a thread into a capture takes a lock, to register the string;
+ * after that, writing takes none. The capture has no put area, since
+ * its pointers would be shared by all threads, so every sputc() and
+ * sputn() reaches overflow() or xsputn() of the calling thread.
+ *
+ * The output is merged only on demand: take() moves out the calling
+ * thread's output, and release() concatenates the output of all
+ * threads, in the order in which they first wrote. release() must not
+ * run while other threads still write.
+ *
+ * sample usage:
+ *     my::Basic_hijack<my::Thread_capture> hj(std::cout);
+ *     std::thread worker([&hj] {
+ *       std::cout << "Hello";
+ *       std::string hello = hj.buffer().take();
+ *     });
+ */
+class Thread_capture : public std::streambuf
+{
+public:
+  Thread_capture()
+  : id_{next_id()}
+  {
+  }
+
+  Thread_capture(const Thread_capture&) = delete;
+  Thread_capture& operator=(const Thread_capture&) = delete;
+
+  /**
+   * Moves out what the calling thread has written so far, and leaves
+   * its string empty for what it writes next.
+   */
+  std::string take()
+  {
+    return std::exchange(local(), {});
+  }
+
+  /**
+   * Moves out what all threads have written so far, one thread after
+   * another.
+   */
+  std::string release()
+  {
+    std::lock_guard lock{mutex_};
+    std::string merged;
+    std::size_t size = 0;
+    for (const auto& l : locals_) {
+      size += l->text.size();
+    }
+    merged.reserve(size);
+    for (auto& l : locals_) {
+      merged += l->text;
+      l->text.clear();
+    }
+    return merged;
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      local().push_back(traits_type::to_char_type(ch));
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override
+  {
+    local().append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+
+private:
+  struct Local {
+    std::thread::id thread;
+    std::string text;
+  };
+
+  // the capture that a thread last wrote to, and its string there
+  struct Cache {
+    std::uint64_t id;
+    std::string* text;
+  };
+
+  std::string& local()
+  {
+    if (cache_.id != id_) [[unlikely]] {
+      cache_ = {id_, &attach()};
+    }
+    return *cache_.text;
+  }
+
+  std::string& attach()
+  {
+    const auto thread = std::this_thread::get_id();
+    std::lock_guard lock{mutex_};
+    for (auto& l : locals_) {
+      if (l->thread == thread) {
+        return l->text;
+      }
+    }
+    locals_.push_back(std::make_unique<Local>(Local{thread, {}}));
+    return locals_.back()->text;
+  }
+
+  // ids are never reused, so a stale cache never matches a new capture
+  static std::uint64_t next_id()
+  {
+    static std::atomic<std::uint64_t> last{0};
+    return last.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  static inline thread_local Cache cache_{0, nullptr};
+
+  const std::uint64_t id_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Local>> locals_;
+};
+
+}
@@ -0,0 +1,171 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+#include <tracked.hpp>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// a distinct type per test case, so that counts do not carry over
+template <int Case>
+struct Tag {
+  int n{0};
+  friend bool operator==(const Tag&, const Tag&) = default;
+};
+
+}
+
+TEST_CASE("default constructed") {
+  using Life = my::Tracked<Tag<0>, 8>;
+  Life::Scope scope;
+  // an integer, since the address outlives the instance
+  std::uintptr_t address = 0;
+  {
+    Life life;
+    address = reinterpret_cast<std::uintptr_t>(&life);
+  }
+  CHECK(scope.diff() == my::Lifetime_counts{.default_constructed = 1, .destructed = 1});
+  const auto events = scope.events();
+  REQUIRE(events.size() == 2);
+  CHECK(events[0].event == my::Lifetime_event::default_constructed);
+  CHECK(events[1].event == my::Lifetime_event::destructed);
+  CHECK(reinterpret_cast<std::uintptr_t>(events[0].object) == address);
+  CHECK(reinterpret_cast<std::uintptr_t>(events[1].object) == address);
+}
+TEST_CASE("value constructed") {
+  using Life = my::Tracked<std::string>;
+  Life::Scope scope;
+  {
+    Life life{"a string"};
+    Life emplaced{std::in_place, 3, 'x'};
+    CHECK(emplaced.value == "xxx");
+    CHECK(scope.diff().live() == 2);
+  }
+  CHECK(scope.diff() == my::Lifetime_counts{.value_constructed = 2, .destructed = 2});
+  CHECK(scope.diff().live() == 0);
+}
+TEST_CASE("copy constructed") {
+  using Life = my::Tracked<Tag<1>, 8>;
+  Life::Scope scope;
+  {
+    Life life1{Tag<1>{1}};
+    life1.value.n++;
+    Life life2{life1};
+    CHECK(life2.value.n == 2);
+    CHECK(scope.events().back() == my::Lifetime_record{my::Lifetime_event::copy_constructed, &life2, &life1});
+  }
+  CHECK(scope.diff().copies() == 1);
+  CHECK(scope.diff().moves() == 0);
+  CHECK(scope.diff().destructed == 2);
+}
+TEST_CASE("move constructed") {
+  using Life = my::Tracked<std::string, 8>;
+  Life::Scope scope;
+  {
+    Life life1{"a string that does not fit in the small buffer"};
+    Life life2{std::move(life1)};
+    CHECK(life1.value.empty());
+    CHECK(scope.events().back() == my::Lifetime_record{my::Lifetime_event::move_constructed, &life2, &life1});
+  }
+  CHECK(scope.diff() == my::Lifetime_counts{.value_constructed = 1, .move_constructed = 1, .destructed = 2});
+}
+TEST_CASE("copy assigned") {
+  using Life = my::Tracked<Tag<2>>;
+  Life::Scope scope;
+  {
+    Life life1;
+    Life life2{Tag<2>{1}};
+    life1 = life2;
+    CHECK(life1 == life2);
+  }
+  CHECK(scope.diff() == my::Lifetime_counts{
+    .default_constructed = 1, .value_constructed = 1, .copy_assigned = 1, .destructed = 2});
+}
+TEST_CASE("move assigned") {
+  using Life = my::Tracked<Tag<3>>;
+  Life::Scope scope;
+  {
+    Life life1;
+    Life life2{Tag<3>{1}};
+    life1 = std::move(life2);
+    CHECK(life1.value.n == 1);
+  }
+  CHECK(scope.diff().move_assigned == 1);
+  CHECK(scope.diff().copies() == 0);
+}
+TEST_CASE("scopes nest") {
+  using Life = my::Tracked<Tag<4>>;
+  Life::Scope outer;
+  Life life1;
+  Life::Scope inner;
+  Life life2{life1};
+  CHECK(outer.diff().constructed() == 2);
+  CHECK(inner.diff().constructed() == 1);
+  CHECK(inner.diff().copies() == 1);
+  CHECK(Life::counts().live() == 2);
+}
+TEST_CASE("the log keeps the last events") {
+  using Life = my::Tracked<Tag<5>, 4>;
+  Life::Scope scope;
+  std::vector<Life> lives;
+  lives.reserve(10);
+  for (int i = 0; i < 10; i++) {
+    lives.emplace_back(Tag<5>{i});
+  }
+  const auto events = scope.events();
+  REQUIRE(events.size() == 4);
+  CHECK(events.front() == my::Lifetime_record{my::Lifetime_event::value_constructed, &lives[6]});
+  CHECK(events.back() == my::Lifetime_record{my::Lifetime_event::value_constructed, &lives[9]});
+  Life::Scope later;
+  lives.pop_back();
+  CHECK(later.events() == std::vector<my::Lifetime_record>{
+    {my::Lifetime_event::destructed, lives.data() + 9},
+  });
+}
+TEST_CASE("no log by default") {
+  using Life = my::Tracked<Tag<6>>;
+  Life::Scope scope;
+  Life life;
+  CHECK(scope.events().empty());
+  CHECK(scope.diff().constructed() == 1);
+}
+TEST_CASE("counted per thread") {
+  using Life = my::Tracked<Tag<7>>;
+  Life::Scope scope;
+  my::Lifetime_counts counted;
+  std::thread worker([&counted] {
+    Life::Scope worker_scope;
+    for (int i = 0; i < 1000; i++) {
+      Life life;
+      Life copy{life};
+    }
+    counted = worker_scope.diff();
+  });
+  worker.join();
+  CHECK(counted.copy_constructed == 1000);
+  CHECK(counted.live() == 0);
+  CHECK(scope.diff() == my::Lifetime_counts{});
+}
+TEST_CASE("no copies across a million operations") {
+  using Item = my::Tracked<std::string>;
+  constexpr int n = 1'000'000;
+  std::vector<Item> items;
+  Item::Scope scope;
+  for (int i = 0; i < n; i++) {
+    items.emplace_back(std::to_string(i));
+  }
+  // growing moves the elements, since their move cannot throw
+  CHECK(scope.diff().copies() == 0);
+  CHECK(scope.diff().value_constructed == n);
+  CHECK(scope.diff().move_constructed > 0);
+  Item::Scope reserved;
+  std::vector<Item> moved;
+  moved.reserve(n);
+  for (auto& item : items) {
+    moved.push_back(std::move(item));
+  }
+  CHECK(reserved.diff() == my::Lifetime_counts{.move_constructed = n});
+}
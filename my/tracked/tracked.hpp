@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace my {
+
+/**
+ * The special member functions called on the instances of a Tracked
+ * type, as counted by Tracked<T>::counts() or by a Tracked<T>::Scope.
+ */
+struct Lifetime_counts
+{
+  std::uint64_t default_constructed{0};
+  std::uint64_t value_constructed{0};
+  std::uint64_t copy_constructed{0};
+  std::uint64_t move_constructed{0};
+  std::uint64_t copy_assigned{0};
+  std::uint64_t move_assigned{0};
+  std::uint64_t destructed{0};
+
+  std::uint64_t constructed() const
+  {
+    return default_constructed + value_constructed + copy_constructed + move_constructed;
+  }
+
+  std::uint64_t copies() const
+  {
+    return copy_constructed + copy_assigned;
+  }
+
+  std::uint64_t moves() const
+  {
+    return move_constructed + move_assigned;
+  }
+
+  // the instances constructed but not destructed, negative if more
+  // were destructed than constructed
+  std::int64_t live() const
+  {
+    return static_cast<std::int64_t>(constructed() - destructed);
+  }
+
+  friend Lifetime_counts operator-(const Lifetime_counts& a, const Lifetime_counts& b)
+  {
+    return {
+      a.default_constructed - b.default_constructed,
+      a.value_constructed - b.value_constructed,
+      a.copy_constructed - b.copy_constructed,
+      a.move_constructed - b.move_constructed,
+      a.copy_assigned - b.copy_assigned,
+      a.move_assigned - b.move_assigned,
+      a.destructed - b.destructed,
+    };
+  }
+
+  friend bool operator==(const Lifetime_counts&, const Lifetime_counts&) = default;
+};
+
+enum class Lifetime_event : std::uint8_t
+{
+  default_constructed,
+  value_constructed,
+  copy_constructed,
+  move_constructed,
+  copy_assigned,
+  move_assigned,
+  destructed,
+};
+
+/**
+ * One entry of the event log: what was called, on which instance, and
+ * for a copy or a move, from which instance.
+ */
+struct Lifetime_record
+{
+  Lifetime_event event;
+  const void* object;
+  const void* other{nullptr};
+
+  friend bool operator==(const Lifetime_record&, const Lifetime_record&) = default;
+};
+
+/**
+ * A T that counts the special member functions called on it, to check
+ * that a code path makes no copies, or exactly the moves it should,
+ * even across millions of operations.
+ *
+ * Each thread counts in its own thread_local Lifetime_counts, one per
+ * Tracked type, so counting costs an increment and takes no lock.
+ * counts() and a Scope see the calls made by the calling thread only.
+ *
+ * With a LogSize, each thread also keeps the last LogSize calls, with
+ * the addresses of the instances, in a ring of Lifetime_records. The
+ * log costs nothing when LogSize is 0, the default.
+ *
+ * A Scope takes a snapshot of the counts when constructed; diff()
+ * returns the calls since, and events() the records logged since.
+ *
+ * sample usage:
+ *     using Item = my::Tracked<std::string>;
+ *     std::vector<Item> items;
+ *     items.reserve(n);
+ *     Item::Scope scope;
+ *     for (int i = 0; i < n; i++) {
+ *       items.emplace_back(std::to_string(i));
+ *     }
+ *     assert(scope.diff().copies() == 0);
+ */
+template <typename T, std::size_t LogSize = 0>
+class Tracked
+{
+public:
+  class Scope
+  {
+  public:
+    Scope()
+    : start_{counts()}, logged_{log_.logged}
+    {
+    }
+
+    Lifetime_counts diff() const
+    {
+      return counts() - start_;
+    }
+
+    // the records logged since the scope began, oldest first, at most
+    // the last LogSize
+    std::vector<Lifetime_record> events() const
+    {
+      std::vector<Lifetime_record> records;
+      if constexpr (LogSize > 0) {
+        const auto logged = log_.logged;
+        const auto first = std::max(logged_, logged - std::min<std::uint64_t>(logged, LogSize));
+        for (auto i = first; i < logged; i++) {
+          records.push_back(log_.records[i % LogSize]);
+        }
+      }
+      return records;
+    }
+
+  private:
+    Lifetime_counts start_;
+    std::uint64_t logged_;
+  };
+
+  Tracked()
+  : value{}
+  {
+    record(Lifetime_event::default_constructed);
+  }
+
+  Tracked(const T& t)
+  : value{t}
+  {
+    record(Lifetime_event::value_constructed);
+  }
+
+  Tracked(T&& t)
+  : value{std::move(t)}
+  {
+    record(Lifetime_event::value_constructed);
+  }
+
+  template <typename... Args>
+    requires std::is_constructible_v<T, Args&&...>
+  explicit Tracked(std::in_place_t, Args&&... args)
+  : value(std::forward<Args>(args)...)
+  {
+    record(Lifetime_event::value_constructed);
+  }
+
+  Tracked(const Tracked& other)
+  : value{other.value}
+  {
+    record(Lifetime_event::copy_constructed, &other);
+  }
+
+  Tracked(Tracked&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+  : value{std::move(other.value)}
+  {
+    record(Lifetime_event::move_constructed, &other);
+  }
+
+  Tracked& operator=(const Tracked& other)
+  {
+    value = other.value;
+    record(Lifetime_event::copy_assigned, &other);
+    return *this;
+  }
+
+  Tracked& operator=(Tracked&& other) noexcept(std::is_nothrow_move_assignable_v<T>)
+  {
+    value = std::move(other.value);
+    record(Lifetime_event::move_assigned, &other);
+    return *this;
+  }
+
+  ~Tracked()
+  {
+    record(Lifetime_event::destructed);
+  }
+
+  friend bool operator==(const Tracked& a, const Tracked& b)
+  {
+    return a.value == b.value;
+  }
+
+  // the calls counted by the calling thread so far
+  static Lifetime_counts counts()
+  {
+    return counts_;
+  }
+
+  T value;
+
+private:
+  struct Log
+  {
+    std::array<Lifetime_record, LogSize> records;
+    std::uint64_t logged{0};
+  };
+
+  void record(Lifetime_event event, const void* other = nullptr) const
+  {
+    switch (event) {
+    case Lifetime_event::default_constructed: counts_.default_constructed++; break;
+    case Lifetime_event::value_constructed: counts_.value_constructed++; break;
+    case Lifetime_event::copy_constructed: counts_.copy_constructed++; break;
+    case Lifetime_event::move_constructed: counts_.move_constructed++; break;
+    case Lifetime_event::copy_assigned: counts_.copy_assigned++; break;
+    case Lifetime_event::move_assigned: counts_.move_assigned++; break;
+    case Lifetime_event::destructed: counts_.destructed++; break;
+    }
+    if constexpr (LogSize > 0) {
+      log_.records[log_.logged % LogSize] = {event, this, other};
+      log_.logged++;
+    }
+  }
+
+  static inline thread_local Lifetime_counts counts_{};
+  static inline thread_local Log log_{};
+};
+
+}
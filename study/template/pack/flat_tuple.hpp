@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+
+// A flat tuple: instead of nesting `tuple<Ts...> rest`, every element
+// lives in its own leaf base class, tagged with its index, and the
+// tuple inherits from all the leaves at once:
+//
+//   flat_tuple<int, double, char>
+//     : tuple_leaf<0, int>, tuple_leaf<1, double>, tuple_leaf<2, char>
+//
+// A tuple of N elements instantiates N leaves and no nested tuples,
+// and `get<N>` finds its leaf by overload resolution on the base class
+// rather than by recursing N levels, so neither the instantiation
+// depth nor the call depth grows with N.
+
+// the leaf that holds the element at the I index
+template <std::size_t I, typename T>
+struct tuple_leaf
+{
+  constexpr const T& get() const noexcept
+  { return value; }
+
+  T value;
+};
+
+// the leaf of an empty element derives from it instead, so that with
+// the empty base optimization it takes no room in the tuple (GCC 12
+// loses the neighbouring element in constant expressions when an empty
+// [[no_unique_address]] member overlaps it)
+template <std::size_t I, typename T>
+  requires (std::is_empty_v<T> && !std::is_final_v<T>)
+struct tuple_leaf<I, T> : T
+{
+  constexpr tuple_leaf(const T& t)
+  : T(t) {}
+
+  constexpr const T& get() const noexcept
+  { return *this; }
+};
+
+template <typename Is, typename... Ts>
+struct flat_tuple_base;
+
+template <std::size_t... Is, typename... Ts>
+struct flat_tuple_base<std::index_sequence<Is...>, Ts...>
+: tuple_leaf<Is, Ts>...
+{
+  constexpr flat_tuple_base(const Ts&... ts)
+  : tuple_leaf<Is, Ts>{ts}... {}
+};
+
+template <typename... Ts>
+struct flat_tuple
+: flat_tuple_base<std::index_sequence_for<Ts...>, Ts...>
+{
+  using flat_tuple_base<std::index_sequence_for<Ts...>, Ts...>::flat_tuple_base;
+
+  constexpr std::size_t size() const
+  { return sizeof...(Ts); }
+};
+
+// the leaf of the element at the N index, found by deducing T from
+// the one base class tuple_leaf<N, T>
+template <std::size_t N, typename T>
+constexpr const tuple_leaf<N, T>& leaf(const tuple_leaf<N, T>& l) noexcept
+{
+  return l;
+}
+
+// the type of the element at the N index, without recursion: an
+// indexer derives from one indexed<I, T> per element, and select<N>
+// deduces T from the base class indexed<N, T>
+template <std::size_t I, typename T>
+struct indexed
+{
+  using value_type = T;
+};
+
+template <typename Is, typename... Ts>
+struct indexer;
+
+template <std::size_t... Is, typename... Ts>
+struct indexer<std::index_sequence<Is...>, Ts...>
+: indexed<Is, Ts>...
+{};
+
+template <std::size_t N, typename T>
+indexed<N, T> select(const indexed<N, T>&);
+
+template <std::size_t N, typename... Ts>
+struct flat_nth_type
+: decltype(select<N>(indexer<std::index_sequence_for<Ts...>, Ts...>{}))
+{
+  static_assert(N < sizeof...(Ts));
+};
+
+// function template that takes a flat tuple as an argument and
+// returns a reference to the element at the N index in the tuple
+template <std::size_t N, typename... Ts>
+constexpr const typename flat_nth_type<N, Ts...>::value_type&
+get(const flat_tuple<Ts...>& t) noexcept
+{
+  return leaf<N>(t).get();
+}
+
+// A packed tuple: the same leaves as a flat tuple, but the base
+// classes are listed from the most to the least aligned element, so
+// that no padding is needed between them:
+//
+//   flat_tuple<char, double, char>    // 24 bytes
+//     : tuple_leaf<0, char>, tuple_leaf<1, double>, tuple_leaf<2, char>
+//
+//   packed_tuple<char, double, char>  // 16 bytes
+//     : tuple_leaf<1, double>, tuple_leaf<0, char>, tuple_leaf<2, char>
+//
+// Each leaf still carries the logical index of its element, so get<N>
+// and the constructor keep the order in which the types are given.
+
+// the indices of the elements from the most to the least aligned,
+// keeping the given order among equally aligned ones
+template <typename... Ts>
+constexpr std::array<std::size_t, sizeof...(Ts)> storage_order()
+{
+  constexpr std::array<std::size_t, sizeof...(Ts)> aligns{alignof(Ts)...};
+  std::array<std::size_t, sizeof...(Ts)> order{};
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    std::size_t j = i;
+    for (; j > 0 && aligns[order[j-1]] < aligns[i]; --j) {
+      order[j] = order[j-1];
+    }
+    order[j] = i;
+  }
+  return order;
+}
+
+template <typename Is, typename... Ts>
+struct packed_order;
+
+template <std::size_t... Is, typename... Ts>
+struct packed_order<std::index_sequence<Is...>, Ts...>
+{
+  static constexpr auto order = storage_order<Ts...>();
+
+  using type = std::index_sequence<order[Is]...>;
+};
+
+template <typename Os, typename... Ts>
+struct packed_tuple_base;
+
+template <std::size_t... Os, typename... Ts>
+struct packed_tuple_base<std::index_sequence<Os...>, Ts...>
+: tuple_leaf<Os, typename flat_nth_type<Os, Ts...>::value_type>...
+{
+  constexpr packed_tuple_base(const Ts&... ts)
+  : packed_tuple_base(flat_tuple<const Ts&...>(ts...)) {}
+
+private:
+  constexpr packed_tuple_base(const flat_tuple<const Ts&...>& ts)
+  : tuple_leaf<Os, typename flat_nth_type<Os, Ts...>::value_type>{get<Os>(ts)}... {}
+};
+
+template <typename... Ts>
+struct packed_tuple
+: packed_tuple_base<typename packed_order<std::index_sequence_for<Ts...>, Ts...>::type, Ts...>
+{
+  using packed_tuple_base<
+    typename packed_order<std::index_sequence_for<Ts...>, Ts...>::type, Ts...
+  >::packed_tuple_base;
+
+  constexpr std::size_t size() const
+  { return sizeof...(Ts); }
+};
+
+// function template that takes a packed tuple as an argument and
+// returns a reference to the element at the N index in the tuple
+template <std::size_t N, typename... Ts>
+constexpr const typename flat_nth_type<N, Ts...>::value_type&
+get(const packed_tuple<Ts...>& t) noexcept
+{
+  return leaf<N>(t).get();
+}
+
+}; // namespace my
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "./tuple.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+
+// A structure of arrays: soa_vector<int, double, char> stores its rows
+// as three columns, an array of int, an array of double and an array of
+// char, instead of an array of tuple<int, double, char>. A scan of one
+// column then reads only that column, packed and aligned for SIMD:
+//
+//   soa_vector<int, double, char> v;
+//   v.push_back(1, 2.0, 'a');
+//   double sum = 0;
+//   for (double d : v.column<1>())
+//     sum += d;
+//
+// The type of the N column is nth_type<N, Ts...>::value_type. A row is
+// read and written through soa_row, a proxy that behaves like a
+// reference to a tuple<Ts...>.
+
+template <typename Vector>
+class soa_row;
+
+template <typename... Ts>
+class soa_vector
+{
+  static_assert(sizeof...(Ts) > 0);
+  static_assert((std::is_nothrow_move_constructible_v<Ts> && ...),
+                "the columns grow by moving their elements");
+
+  template <std::size_t N>
+  using column_type = typename nth_type<N, Ts...>::value_type;
+
+  using indices = std::index_sequence_for<Ts...>;
+  using columns_type = std::array<void*, sizeof...(Ts)>;
+
+public:
+  // the alignment of every column, a cache line
+  static constexpr std::size_t alignment = 64;
+
+  using value_type = tuple<Ts...>;
+  using reference = soa_row<soa_vector>;
+  using const_reference = soa_row<const soa_vector>;
+
+  soa_vector() = default;
+
+  // delegates, so that the destructor frees what was copied if an
+  // element throws
+  soa_vector(const soa_vector& other)
+  : soa_vector()
+  {
+    reserve(other.size_);
+    copy_from(other, indices{});
+  }
+
+  soa_vector(soa_vector&& other) noexcept
+  : columns_{std::exchange(other.columns_, {})},
+    size_{std::exchange(other.size_, 0)},
+    capacity_{std::exchange(other.capacity_, 0)} {}
+
+  soa_vector& operator=(soa_vector other) noexcept
+  {
+    std::swap(columns_, other.columns_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    return *this;
+  }
+
+  ~soa_vector()
+  {
+    clear();
+    deallocate(columns_, indices{});
+  }
+
+  std::size_t size() const noexcept
+  { return size_; }
+
+  std::size_t capacity() const noexcept
+  { return capacity_; }
+
+  bool empty() const noexcept
+  { return size_ == 0; }
+
+  // the N column, one element per row
+  template <std::size_t N>
+  std::span<column_type<N>> column() noexcept
+  { return {data<N>(), size_}; }
+
+  template <std::size_t N>
+  std::span<const column_type<N>> column() const noexcept
+  { return {data<N>(), size_}; }
+
+  reference operator[](std::size_t i) noexcept
+  { return {*this, i}; }
+
+  const_reference operator[](std::size_t i) const noexcept
+  { return {*this, i}; }
+
+  void reserve(std::size_t capacity)
+  {
+    if (capacity > capacity_) {
+      auto columns = allocate(capacity, indices{});
+      adopt(columns, capacity, indices{});
+    }
+  }
+
+  void push_back(const Ts&... ts)
+  {
+    emplace_back(ts...);
+  }
+
+  void push_back(const value_type& t)
+  {
+    push_back(t, indices{});
+  }
+
+  // constructs the element of every column from one argument each
+  template <typename... Args>
+  void emplace_back(Args&&... args)
+  {
+    static_assert(sizeof...(Args) == sizeof...(Ts),
+                  "one argument per column");
+    if (size_ == capacity_) {
+      // like std::vector, the new row is constructed before the old
+      // rows are moved, so the arguments may refer to them
+      const std::size_t capacity = capacity_ == 0 ? 16 : 2 * capacity_;
+      auto columns = allocate(capacity, indices{});
+      try {
+        construct(columns, indices{}, std::forward<Args>(args)...);
+      } catch (...) {
+        deallocate(columns, indices{});
+        throw;
+      }
+      adopt(columns, capacity, indices{});
+    } else {
+      construct(columns_, indices{}, std::forward<Args>(args)...);
+    }
+    ++size_;
+  }
+
+  void pop_back() noexcept
+  {
+    --size_;
+    destroy(size_, size_ + 1, indices{});
+  }
+
+  void clear() noexcept
+  {
+    destroy(0, size_, indices{});
+    size_ = 0;
+  }
+
+private:
+  template <typename Vector>
+  friend class soa_row;
+
+  template <std::size_t N>
+  column_type<N>* data() noexcept
+  {
+    return std::assume_aligned<alignment>(
+      static_cast<column_type<N>*>(columns_[N]));
+  }
+
+  template <std::size_t N>
+  const column_type<N>* data() const noexcept
+  {
+    return std::assume_aligned<alignment>(
+      static_cast<const column_type<N>*>(columns_[N]));
+  }
+
+  template <std::size_t... Is>
+  void push_back(const value_type& t, std::index_sequence<Is...>)
+  {
+    emplace_back(get<Is>(t)...);
+  }
+
+  // constructs the row at size_ in the columns, and destroys what was
+  // constructed of it if a constructor throws
+  template <std::size_t... Is, typename... Args>
+  void construct(columns_type& columns, std::index_sequence<Is...>, Args&&... args)
+  {
+    std::size_t constructed = 0;
+    try {
+      ((std::construct_at(static_cast<Ts*>(columns[Is]) + size_, std::forward<Args>(args)),
+        ++constructed), ...);
+    } catch (...) {
+      ((Is < constructed ? std::destroy_at(static_cast<Ts*>(columns[Is]) + size_) : void()), ...);
+      throw;
+    }
+  }
+
+  template <std::size_t... Is>
+  void destroy(std::size_t first, std::size_t last, std::index_sequence<Is...>) noexcept
+  {
+    (std::destroy(data<Is>() + first, data<Is>() + last), ...);
+  }
+
+  template <std::size_t... Is>
+  void copy_from(const soa_vector& other, std::index_sequence<Is...>)
+  {
+    for (std::size_t i = 0; i < other.size_; ++i) {
+      emplace_back(other.data<Is>()[i]...);
+    }
+  }
+
+  // allocates all the columns, or none if an allocation fails
+  template <std::size_t... Is>
+  static columns_type allocate(std::size_t capacity, std::index_sequence<Is...>)
+  {
+    columns_type columns{};
+    try {
+      ((columns[Is] = ::operator new(capacity * sizeof(Ts),
+                                     std::align_val_t{alignment})), ...);
+    } catch (...) {
+      deallocate(columns, indices{});
+      throw;
+    }
+    return columns;
+  }
+
+  // moves the rows into the new columns, which cannot fail, and frees
+  // the old ones
+  template <std::size_t... Is>
+  void adopt(columns_type& columns, std::size_t capacity, std::index_sequence<Is...>) noexcept
+  {
+    (std::uninitialized_move(data<Is>(), data<Is>() + size_,
+                             static_cast<Ts*>(columns[Is])), ...);
+    destroy(0, size_, indices{});
+    deallocate(columns_, indices{});
+    columns_ = columns;
+    capacity_ = capacity;
+  }
+
+  template <std::size_t... Is>
+  static void deallocate(columns_type& columns,
+                         std::index_sequence<Is...>) noexcept
+  {
+    (::operator delete(columns[Is], std::align_val_t{alignment}), ...);
+  }
+
+  columns_type columns_{};
+  std::size_t size_{0};
+  std::size_t capacity_{0};
+};
+
+// A row of a soa_vector: get<N>(row) is a reference to the element of
+// the row in the N column, const if the vector is. A row converts to
+// the value_type of the vector, a tuple with copies of its elements,
+// and assigning a tuple to it assigns every element.
+template <typename Vector>
+class soa_row
+{
+  using value_type = typename std::remove_const_t<Vector>::value_type;
+
+public:
+  constexpr soa_row(Vector& v, std::size_t i) noexcept
+  : vector_{&v}, index_{i} {}
+
+  soa_row(const soa_row&) = default;
+
+  // assigns the elements of another row, not the proxy
+  const soa_row& operator=(const soa_row& other) const
+  {
+    assign(other, std::make_index_sequence<size()>{});
+    return *this;
+  }
+
+  const soa_row& operator=(const value_type& t) const
+  {
+    assign(t, std::make_index_sequence<size()>{});
+    return *this;
+  }
+
+  operator value_type() const
+  {
+    return to_value(std::make_index_sequence<size()>{});
+  }
+
+  static constexpr std::size_t size()
+  { return value_type_size(static_cast<value_type*>(nullptr)); }
+
+  template <std::size_t N, typename V>
+  friend constexpr decltype(auto) get(const soa_row<V>& r) noexcept;
+
+private:
+  template <typename... Ts>
+  static constexpr std::size_t value_type_size(tuple<Ts...>*)
+  { return sizeof...(Ts); }
+
+  template <std::size_t N>
+  auto& element() const noexcept
+  {
+    return vector_->template data<N>()[index_];
+  }
+
+  template <std::size_t... Is>
+  value_type to_value(std::index_sequence<Is...>) const
+  {
+    return value_type(element<Is>()...);
+  }
+
+  template <typename Tuple, std::size_t... Is>
+  void assign(const Tuple& t, std::index_sequence<Is...>) const
+  {
+    ((element<Is>() = get<Is>(t)), ...);
+  }
+
+  Vector* vector_;
+  std::size_t index_;
+};
+
+// function template that takes a row of a soa_vector as an argument
+// and returns a reference to its element in the N column
+template <std::size_t N, typename Vector>
+constexpr decltype(auto) get(const soa_row<Vector>& r) noexcept
+{
+  return r.template element<N>();
+}
+
+}; // namespace my
@@ -0,0 +1,84 @@
+// Sums one column of a million records stored
+// - as an array of tuples, std::vector<my::tuple<int, double, char>>,
+//   which reads every record in whole, 24 bytes for an 8-byte double;
+// - as a structure of arrays, my::soa_vector<int, double, char>, which
+//   reads the column of doubles alone.
+// The same for records of eight doubles, summing one of them.
+//
+// Uses the harness of the ring buffer benchmarks, which writes JSON,
+// and reports the time per record. Build with optimization and run,
+// e.g.
+//     g++ -std=c++20 -O2 -march=native -DNDEBUG -I../../../ex/ring_buffer/cpp17 soa_vector_bench.cpp -o soa_vector_bench
+//     ./soa_vector_bench
+#include "./soa_vector.hpp"
+#include <bench.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t rows = 1'000'000;
+
+// sums the column of every record over and over until iterations
+// records have been read
+template <typename Column>
+void sum_column(std::uint64_t iterations, const Column& column)
+{
+  double sum = 0;
+  for (std::uint64_t done = 0; done < iterations; done += rows) {
+    const auto n = std::min<std::uint64_t>(rows, iterations - done);
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += column(i);
+    }
+    my::bench::do_not_optimize(sum);
+  }
+}
+
+template <typename... Ts, std::size_t N, typename Make>
+void add(my::bench::Suite& suite, const char* name, std::integral_constant<std::size_t, N>, Make make)
+{
+  auto aos = std::make_shared<std::vector<my::tuple<Ts...>>>();
+  auto soa = std::make_shared<my::soa_vector<Ts...>>();
+  aos->reserve(rows);
+  soa->reserve(rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    aos->push_back(make(i));
+    soa->push_back(make(i));
+  }
+  const std::size_t bytes = sizeof(my::tuple<Ts...>);
+  suite.add({std::string{"aos/"} + name, 1, bytes}, [aos](std::uint64_t iterations) {
+    const auto& v = *aos;
+    sum_column(iterations, [&v](std::size_t i) { return my::get<N>(v[i]); });
+  });
+  suite.add({std::string{"soa/"} + name, 1, bytes}, [soa](std::uint64_t iterations) {
+    const auto column = std::as_const(*soa).template column<N>();
+    sum_column(iterations, [column](std::size_t i) { return column[i]; });
+  });
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  my::bench::Suite suite;
+
+  add<int, double, char>(suite, "int_double_char", std::integral_constant<std::size_t, 1>{},
+    [](std::size_t i) {
+      return my::tuple<int, double, char>(int(i), double(i), char(i));
+    });
+  add<double, double, double, double, double, double, double, double>(
+    suite, "8_doubles", std::integral_constant<std::size_t, 3>{},
+    [](std::size_t i) {
+      const double d = double(i);
+      return my::tuple<double, double, double, double, double, double, double, double>(
+        d, d, d, d, d, d, d, d);
+    });
+
+  return suite.main(argc, argv);
+}
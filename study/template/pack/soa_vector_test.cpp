@@ -0,0 +1,151 @@
+// #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+// #include <doctest.h>
+#include "./soa_vector.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using records = my::soa_vector<int, double, char>;
+
+static_assert(std::is_same_v<std::span<int>,          decltype(std::declval<records&>().column<0>())>);
+static_assert(std::is_same_v<std::span<double>,       decltype(std::declval<records&>().column<1>())>);
+static_assert(std::is_same_v<std::span<const char>,   decltype(std::declval<const records&>().column<2>())>);
+static_assert(std::is_same_v<double&,       decltype(get<1>(std::declval<records::reference>()))>);
+static_assert(std::is_same_v<double const&, decltype(get<1>(std::declval<records::const_reference>()))>);
+static_assert(std::is_same_v<double&,       decltype(my::get<1>(std::declval<records::reference>()))>);
+static_assert(std::is_convertible_v<records::reference, my::tuple<int, double, char>>);
+static_assert(3 == records::reference::size());
+
+// the column blocks live, counted by the aligned operator new
+int aligned_blocks = 0;
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  void* p = std::aligned_alloc(static_cast<std::size_t>(align),
+                               (size + static_cast<std::size_t>(align) - 1)
+                               / static_cast<std::size_t>(align) * static_cast<std::size_t>(align));
+  if (p == nullptr)
+    throw std::bad_alloc{};
+  ++aligned_blocks;
+  return p;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+  if (p != nullptr) {
+    --aligned_blocks;
+    std::free(p);
+  }
+}
+
+// throws from its copy constructor once armed
+struct fragile
+{
+  static inline int copies_left = -1;
+
+  fragile() = default;
+  fragile(fragile&&) noexcept = default;
+  fragile(const fragile&)
+  {
+    if (copies_left == 0)
+      throw std::runtime_error("copy");
+    --copies_left;
+  }
+};
+
+int main()
+{
+  records v;
+  assert(v.empty());
+  for (int i = 0; i < 1000; ++i) {
+    v.push_back(i, i * 0.5, char('a' + i % 26));
+  }
+  v.push_back(my::tuple<int, double, char>(1000, 500.0, 'm'));
+  v.emplace_back(1001, 500.5, 'n');
+  assert(v.size() == 1002);
+  assert(v.capacity() >= v.size());
+
+  // every column is aligned, and holds its elements in order
+  assert(reinterpret_cast<std::uintptr_t>(v.column<0>().data()) % records::alignment == 0);
+  assert(reinterpret_cast<std::uintptr_t>(v.column<1>().data()) % records::alignment == 0);
+  assert(reinterpret_cast<std::uintptr_t>(v.column<2>().data()) % records::alignment == 0);
+  assert(std::accumulate(v.column<0>().begin(), v.column<0>().end(), 0) == 1001 * 1002 / 2);
+  assert(v.column<2>()[27] == 'b');
+
+  // rows read and write through to the columns
+  auto row = v[3];
+  assert(get<0>(row) == 3 && get<1>(row) == 1.5 && get<2>(row) == 'd');
+  get<1>(row) = 7.5;
+  assert(v.column<1>()[3] == 7.5);
+  row = my::tuple<int, double, char>(-3, -1.5, 'z');
+  assert(v.column<0>()[3] == -3 && v.column<2>()[3] == 'z');
+  v[4] = v[3];
+  assert(v.column<0>()[4] == -3 && v.column<1>()[4] == -1.5);
+  my::tuple<int, double, char> copy = v[1001];
+  assert(my::get<0>(copy) == 1001 && my::get<2>(copy) == 'n');
+
+  const records& cv = v;
+  assert(get<0>(cv[5]) == 5);
+  // like for a tuple, also qualified
+  assert(my::get<0>(v[5]) == 5 && my::get<0>(cv[5]) == 5);
+
+  // copies and moves
+  records w = v;
+  assert(w.size() == v.size() && w.column<1>()[4] == -1.5);
+  records m = std::move(w);
+  assert(w.empty() && m.size() == v.size());
+  w = m;
+  assert(w.column<0>()[1001] == 1001);
+
+  v.pop_back();
+  assert(v.size() == 1001);
+  v.clear();
+  assert(v.empty());
+
+  // columns of non-trivial types
+  my::soa_vector<std::string, int> s;
+  for (int i = 0; i < 100; ++i) {
+    s.emplace_back(std::string(32, char('a' + i % 26)), i);
+  }
+  assert(s.column<0>()[99] == std::string(32, 'v'));
+
+  // the arguments may be elements of the vector itself, also when it
+  // grows
+  my::soa_vector<std::string, int> self;
+  self.push_back(std::string(32, 'a'), 1);
+  while (self.size() < self.capacity()) {
+    self.push_back(std::string(32, 'b'), 2);
+  }
+  self.push_back(self.column<0>()[0], self.column<1>()[0]);
+  assert(self.column<0>().back() == std::string(32, 'a') && self.column<1>().back() == 1);
+
+  // a throwing constructor leaves no partial row
+  my::soa_vector<std::string, fragile> f;
+  fragile armed;
+  f.push_back("one", armed);
+  fragile::copies_left = 0;
+  try {
+    f.push_back("two", armed);
+    assert(false);
+  } catch (const std::runtime_error&) {
+  }
+  assert(f.size() == 1 && f.column<0>()[0] == "one");
+
+  // nor does a copy of the vector
+  fragile::copies_left = -1;
+  f.push_back("two", armed);
+  fragile::copies_left = 1;
+  const int blocks = aligned_blocks;
+  try {
+    my::soa_vector<std::string, fragile> copy = f;
+    assert(false);
+  } catch (const std::runtime_error&) {
+  }
+  assert(aligned_blocks == blocks);
+}
@@ -1,4 +1,9 @@
+#pragma once
+
 #include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace my {
 
@@ -9,6 +14,13 @@ struct tuple
   constexpr tuple(const T& t, const Ts&... ts)
   : value{t}, rest{ts...} {}
 
+  // forwards the arguments, so that temporaries are moved in and
+  // not copied
+  template <typename U, typename... Us>
+    requires (sizeof...(Us) == sizeof...(Ts) && std::is_constructible_v<T, U&&>)
+  constexpr tuple(U&& u, Us&&... us)
+  : value(std::forward<U>(u)), rest(std::forward<Us>(us)...) {}
+
   constexpr std::size_t size() const
   { return 1 + rest.size(); }
 
@@ -23,6 +35,11 @@ struct tuple<T>
   constexpr tuple(const T& t)
   : value{t} {}
 
+  template <typename U>
+    requires (!std::is_same_v<std::remove_cvref_t<U>, tuple> && std::is_constructible_v<T, U&&>)
+  constexpr tuple(U&& u)
+  : value(std::forward<U>(u)) {}
+
   constexpr std::size_t size() const
   { return 1; }
 
@@ -55,6 +72,13 @@ struct getter
   {
     return getter<N-1>::get(t.rest);
   }
+
+  template <typename... Ts>
+  constexpr static typename nth_type<N, Ts...>::value_type&
+  get(tuple<Ts...>& t) noexcept
+  {
+    return getter<N-1>::get(t.rest);
+  }
 };
 
 template <>
@@ -66,6 +90,13 @@ struct getter<0>
   {
     return t.value;
   }
+
+  template <typename T, typename... Ts>
+  constexpr static T&
+  get(tuple<T, Ts...>& t) noexcept
+  {
+    return t.value;
+  }
 };
 
 // function template that takes a tuple as an argument and
@@ -77,4 +108,31 @@ get(const tuple<Ts...>& t) noexcept
   return getter<N>::get(t);
 }
 
+// the same, for a tuple that can be modified or moved from
+template <std::size_t N, typename... Ts>
+constexpr typename nth_type<N, Ts...>::value_type&
+get(tuple<Ts...>& t) noexcept
+{
+  return getter<N>::get(t);
+}
+
+template <std::size_t N, typename... Ts>
+constexpr typename nth_type<N, Ts...>::value_type&&
+get(tuple<Ts...>&& t) noexcept
+{
+  return std::forward<typename nth_type<N, Ts...>::value_type>(getter<N>::get(t));
+}
+
 }; // namespace my
+
+// the tuple-like protocol, for structured bindings:
+//   auto [i, d, c] = my::tuple<int, double, char>(42, 53.0, 'a');
+template <typename... Ts>
+struct std::tuple_size<my::tuple<Ts...>>
+: std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t N, typename... Ts>
+struct std::tuple_element<N, my::tuple<Ts...>>
+{
+  using type = typename my::nth_type<N, Ts...>::value_type;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "./tuple.hpp"
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+
+// Algorithms over the elements of a tuple. Each one expands the
+// elements with an index_sequence into a fold expression or a pack
+// expansion, so that a call compiles to straight-line code, one
+// statement per element, with no recursive function templates left
+// for the optimizer to flatten.
+//
+// They take any tuple-like type with std::tuple_size and a get<N>
+// found by argument-dependent lookup, my::tuple as well as std::tuple.
+
+template <typename Tuple>
+using indices_of = std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple>>>;
+
+template <typename F, typename Tuple, std::size_t... Is>
+constexpr decltype(auto) apply(F&& f, Tuple&& t, std::index_sequence<Is...>)
+{
+  using std::get;
+  return std::invoke(std::forward<F>(f), get<Is>(std::forward<Tuple>(t))...);
+}
+
+// calls f with the elements of the tuple as arguments
+//   apply(f, tuple<int, double>(1, 2.0))  ->  f(1, 2.0)
+template <typename F, typename Tuple>
+constexpr decltype(auto) apply(F&& f, Tuple&& t)
+{
+  return apply(std::forward<F>(f), std::forward<Tuple>(t), indices_of<Tuple>{});
+}
+
+template <typename Tuple, typename F, std::size_t... Is>
+constexpr void for_each(Tuple&& t, F& f, std::index_sequence<Is...>)
+{
+  using std::get;
+  (std::invoke(f, get<Is>(std::forward<Tuple>(t))), ...);
+}
+
+// calls f with every element of the tuple, from the first to the last
+//   for_each(tuple<int, double>(1, 2.0), f)  ->  f(1), f(2.0)
+template <typename Tuple, typename F>
+constexpr F for_each(Tuple&& t, F f)
+{
+  for_each(std::forward<Tuple>(t), f, indices_of<Tuple>{});
+  return f;
+}
+
+template <typename Tuple, typename F, std::size_t... Is>
+constexpr auto transform(Tuple&& t, F& f, std::index_sequence<Is...>)
+{
+  using std::get;
+  // braces, so that f is called from the first to the last element
+  return tuple<std::decay_t<std::invoke_result_t<F&, decltype(get<Is>(std::forward<Tuple>(t)))>>...>{
+    std::invoke(f, get<Is>(std::forward<Tuple>(t)))...};
+}
+
+// a tuple of the results of f called with every element of the tuple,
+// decayed like by std::make_tuple
+//   transform(tuple<int, double>(1, 2.0), f)  ->  tuple(f(1), f(2.0))
+template <typename Tuple, typename F>
+constexpr auto transform(Tuple&& t, F f)
+{
+  return transform(std::forward<Tuple>(t), f, indices_of<Tuple>{});
+}
+
+// For every element of the concatenation, the index of its tuple
+// among the arguments (outer) and its index in that tuple (inner):
+//   tuple<A, B>, tuple<C>, tuple<D, E>
+//   outer = {0, 0, 1, 2, 2}
+//   inner = {0, 1, 0, 0, 1}
+template <typename... Tuples>
+struct cat_indices
+{
+  static constexpr std::size_t sizes[] = {std::tuple_size_v<Tuples>..., 0};
+  static constexpr std::size_t size = (std::tuple_size_v<Tuples> + ... + 0);
+
+  static constexpr auto make()
+  {
+    std::array<std::size_t, size> outer{}, inner{};
+    std::size_t k = 0;
+    for (std::size_t o = 0; o < sizeof...(Tuples); ++o) {
+      for (std::size_t i = 0; i < sizes[o]; ++i, ++k) {
+        outer[k] = o;
+        inner[k] = i;
+      }
+    }
+    return std::pair{outer, inner};
+  }
+
+  static constexpr std::array<std::size_t, size> outer = make().first;
+  static constexpr std::array<std::size_t, size> inner = make().second;
+};
+
+template <std::size_t... Ks, typename... Tuples>
+constexpr auto tuple_cat(std::index_sequence<Ks...>, Tuples&&... ts)
+{
+  using std::get;
+  using indices = cat_indices<std::remove_cvref_t<Tuples>...>;
+  // the arguments, to pick the tuple of every element by its index
+  tuple<std::remove_reference_t<Tuples>&...> args(ts...);
+  return tuple<
+    std::tuple_element_t<
+      indices::inner[Ks],
+      std::remove_cvref_t<typename nth_type<indices::outer[Ks], Tuples...>::value_type>
+    >...
+  >{
+    get<indices::inner[Ks]>(
+      std::forward<typename nth_type<indices::outer[Ks], Tuples...>::value_type>(
+        get<indices::outer[Ks]>(args)))...
+  };
+}
+
+// a tuple of the elements of all the tuples, in order; the elements of
+// tuples passed as rvalues are moved
+//   tuple_cat(tuple<int>(1), tuple<double, char>(2.0, 'a'))
+//     -> tuple<int, double, char>(1, 2.0, 'a')
+template <typename... Tuples>
+constexpr auto tuple_cat(Tuples&&... ts)
+{
+  constexpr std::size_t size = cat_indices<std::remove_cvref_t<Tuples>...>::size;
+  static_assert(size > 0, "my::tuple has at least one element");
+  return tuple_cat(std::make_index_sequence<size>{}, std::forward<Tuples>(ts)...);
+}
+
+}; // namespace my
@@ -0,0 +1,46 @@
+// Compile-time benchmark of the recursive my::tuple against the flat
+// my::flat_tuple. Builds a tuple of ELEMENTS distinct types and reads
+// every element with get<N> in a constant expression, which
+// instantiates nth_type and get for every index.
+//
+// Time the compiler, not the program, e.g.
+//     for n in 8 32 128; do
+//       for v in RECURSIVE FLAT; do
+//         echo "$v $n"
+//         time g++ -std=c++20 -fsyntax-only -D$v -DELEMENTS=$n tuple_bench.cpp
+//       done
+//     done
+#include "./tuple.hpp"
+#include "./flat_tuple.hpp"
+#include <cstddef>
+#include <utility>
+
+#ifndef ELEMENTS
+#define ELEMENTS 32
+#endif
+
+#if defined(FLAT)
+template <typename... Ts>
+using bench_tuple = my::flat_tuple<Ts...>;
+#else
+template <typename... Ts>
+using bench_tuple = my::tuple<Ts...>;
+#endif
+
+// a distinct type for every index
+template <std::size_t I>
+struct element
+{
+  std::size_t value;
+};
+
+template <std::size_t... Is>
+constexpr std::size_t sum(std::index_sequence<Is...>)
+{
+  constexpr bench_tuple<element<Is>...> t(element<Is>{Is}...);
+  return (my::get<Is>(t).value + ...);
+}
+
+static_assert(sum(std::make_index_sequence<ELEMENTS>{}) == ELEMENTS * (ELEMENTS - 1) / 2);
+
+int main(){}
@@ -1,6 +1,8 @@
 // #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 // #include <doctest.h>
 #include "./tuple.hpp"
+#include "./flat_tuple.hpp"
+#include "./tuple_algorithm.hpp"
 
 constexpr my::tuple<int> one(42);
 constexpr my::tuple<int, double> two(42, 53.0);
@@ -28,4 +30,164 @@ static_assert(std::is_same_v<int    const&, decltype(my::get<0>(three))>);
 static_assert(std::is_same_v<double const&, decltype(my::get<1>(three))>);
 static_assert(std::is_same_v<char   const&, decltype(my::get<2>(three))>);
 
+// get<N> on a tuple that can be modified or moved from
+static_assert(std::is_same_v<int&,  decltype(my::get<0>(std::declval<my::tuple<int, char>&>()))>);
+static_assert(std::is_same_v<char&, decltype(my::get<1>(std::declval<my::tuple<int, char>&>()))>);
+static_assert(std::is_same_v<char&&, decltype(my::get<1>(std::declval<my::tuple<int, char>&&>()))>);
+static_assert(std::is_same_v<int&,  decltype(my::get<0>(std::declval<my::tuple<int&, char>&&>()))>);
+static_assert([] {
+  my::tuple<int, double> t(1, 2.0);
+  my::get<0>(t) = 3;
+  my::get<1>(t) *= 2;
+  return my::get<0>(t) == 3 && my::get<1>(t) == 4.0;
+}());
+
+// counts the copies and the moves it went through
+struct probe
+{
+  int copies = 0;
+  int moves = 0;
+
+  constexpr probe() = default;
+  constexpr probe(const probe& p) : copies{p.copies + 1}, moves{p.moves} {}
+  constexpr probe(probe&& p) : copies{p.copies}, moves{p.moves + 1} {}
+};
+
+// temporaries are moved into a tuple, not copied
+static_assert(0 == my::get<0>(my::tuple<probe>(probe{})).copies);
+static_assert(0 == my::get<1>(my::tuple<int, probe>(1, probe{})).copies);
+static_assert(1 == my::get<1>(my::tuple<int, probe>(1, probe{})).moves);
+static_assert([] {
+  probe p;
+  my::tuple<probe, probe> t(p, std::move(p));
+  return my::get<0>(t).copies == 1 && my::get<1>(t).copies == 0;
+}());
+// and converted
+static_assert(2.0 == my::get<0>(my::tuple<double, char>(2, 'a')));
+
+// structured bindings
+static_assert(3 == std::tuple_size_v<my::tuple<int, double, char>>);
+static_assert(3 == std::tuple_size_v<const my::tuple<int, double, char>>);
+static_assert(std::is_same_v<double, std::tuple_element_t<1, my::tuple<int, double, char>>>);
+static_assert(std::is_same_v<const char, std::tuple_element_t<2, const my::tuple<int, double, char>>>);
+static_assert([] {
+  auto [i, d, c] = three;
+  auto& [ri, rd, rc] = three;
+  my::tuple<int, double> t(1, 2.0);
+  auto& [ti, td] = t;
+  ti = 5;
+  return i == 42 && d == 53.0 && c == 'a' && &ri == &three.value && my::get<0>(t) == 5;
+}());
+
+// apply, for_each, transform
+static_assert(42 + 53.0 + 'a' == my::apply([](int i, double d, char c) { return i + d + c; }, three));
+static_assert(std::is_same_v<const int&, decltype(my::apply([](const int& i) -> decltype(auto) { return (i); }, one))>);
+static_assert([] {
+  double sum = 0;
+  my::for_each(three, [&sum](auto x) { sum = sum * 100 + x; });
+  return sum == (42 * 100 + 53.0) * 100 + 'a';
+}());
+static_assert([] {
+  my::tuple<int, double> t(1, 2.0);
+  my::for_each(t, [](auto& x) { x *= 10; });
+  return my::get<0>(t) == 10 && my::get<1>(t) == 20.0;
+}());
+static_assert([] {
+  auto doubled = my::transform(three, [](auto x) { return x * 2; });
+  static_assert(std::is_same_v<decltype(doubled), my::tuple<int, double, int>>);
+  return my::get<0>(doubled) == 84 && my::get<1>(doubled) == 106.0 && my::get<2>(doubled) == 'a' * 2;
+}());
+static_assert([] {
+  int order = 0;
+  auto calls = my::transform(three, [&order](auto) { return order++; });
+  return my::get<0>(calls) == 0 && my::get<1>(calls) == 1 && my::get<2>(calls) == 2;
+}());
+// also for std::tuple
+static_assert(3 == my::apply([](int a, int b) { return a + b; }, std::tuple<int, int>(1, 2)));
+
+// tuple_cat
+static_assert(std::is_same_v<my::tuple<int, int, double, int, double, char>,
+                             decltype(my::tuple_cat(one, two, three))>);
+static_assert([] {
+  auto t = my::tuple_cat(one, two, three);
+  return my::get<0>(t) == 42 && my::get<2>(t) == 53.0 && my::get<5>(t) == 'a';
+}());
+static_assert(std::is_same_v<my::tuple<int, char>, decltype(my::tuple_cat(one, std::tuple<char>('a')))>);
+static_assert([] {
+  my::tuple<probe, int> t(probe{}, 1);
+  auto moved = my::tuple_cat(std::move(t), my::tuple<probe>(probe{}));
+  auto copied = my::tuple_cat(moved);
+  return my::get<0>(moved).copies == 0 && my::get<2>(moved).copies == 0
+      && my::get<0>(copied).copies == 1;
+}());
+
+constexpr my::flat_tuple<> flat_none;
+constexpr my::flat_tuple<int> flat_one(42);
+constexpr my::flat_tuple<int, double> flat_two(42, 53.0);
+constexpr my::flat_tuple<int, double, char> flat_three(42, 53.0, 'a');
+
+static_assert(0 == flat_none.size());
+static_assert(1 == flat_one.size());
+static_assert(3 == flat_three.size());
+
+static_assert(  42 == my::get<0>(flat_one));
+static_assert(  42 == my::get<0>(flat_two));
+static_assert(53.0 == my::get<1>(flat_two));
+static_assert(  42 == my::get<0>(flat_three));
+static_assert(53.0 == my::get<1>(flat_three));
+static_assert( 'a' == my::get<2>(flat_three));
+
+static_assert(std::is_same_v<int    const&, decltype(my::get<0>(flat_one))>);
+static_assert(std::is_same_v<int    const&, decltype(my::get<0>(flat_two))>);
+static_assert(std::is_same_v<double const&, decltype(my::get<1>(flat_two))>);
+static_assert(std::is_same_v<int    const&, decltype(my::get<0>(flat_three))>);
+static_assert(std::is_same_v<double const&, decltype(my::get<1>(flat_three))>);
+static_assert(std::is_same_v<char   const&, decltype(my::get<2>(flat_three))>);
+
+static_assert(std::is_same_v<int,  my::flat_nth_type<0, int, double, char>::value_type>);
+static_assert(std::is_same_v<char, my::flat_nth_type<2, int, double, char>::value_type>);
+// the same type twice is no ambiguity, the leaves differ by index
+static_assert(std::is_same_v<int,  my::flat_nth_type<1, char, int, int>::value_type>);
+constexpr my::flat_tuple<int, int> flat_same(1, 2);
+static_assert(1 == my::get<0>(flat_same));
+static_assert(2 == my::get<1>(flat_same));
+
+constexpr my::packed_tuple<> packed_none;
+constexpr my::packed_tuple<char, double, char> packed_three('a', 53.0, 'b');
+
+static_assert(0 == packed_none.size());
+static_assert(3 == packed_three.size());
+
+static_assert( 'a' == my::get<0>(packed_three));
+static_assert(53.0 == my::get<1>(packed_three));
+static_assert( 'b' == my::get<2>(packed_three));
+
+static_assert(std::is_same_v<char   const&, decltype(my::get<0>(packed_three))>);
+static_assert(std::is_same_v<double const&, decltype(my::get<1>(packed_three))>);
+static_assert(std::is_same_v<char   const&, decltype(my::get<2>(packed_three))>);
+
+// stored from the most to the least aligned, stable among equals
+static_assert(my::storage_order<char, double, char>() == std::array<std::size_t, 3>{1, 0, 2});
+static_assert(my::storage_order<char, short, int, double>() == std::array<std::size_t, 4>{3, 2, 1, 0});
+
+// declaration order pads each char up to the alignment of double
+static_assert(sizeof(my::tuple<char, double, char>) == 3 * sizeof(double));
+static_assert(sizeof(my::flat_tuple<char, double, char>) == 3 * sizeof(double));
+static_assert(sizeof(my::packed_tuple<char, double, char>) == 2 * sizeof(double));
+static_assert(sizeof(my::packed_tuple<char, int, short, double>) == 2 * sizeof(double));
+static_assert(alignof(my::packed_tuple<char, double, char>) == alignof(double));
+
+// empty elements take no room
+struct tag {};
+struct other_tag {};
+static_assert(sizeof(my::flat_tuple<tag, int>) == sizeof(int));
+static_assert(sizeof(my::packed_tuple<tag, int>) == sizeof(int));
+static_assert(sizeof(my::packed_tuple<int, tag, other_tag>) == sizeof(int));
+static_assert(sizeof(my::packed_tuple<tag, char, double, other_tag, char>) == 2 * sizeof(double));
+static_assert(std::is_empty_v<my::packed_tuple<tag, other_tag>>);
+
+constexpr my::packed_tuple<tag, int, other_tag> packed_tagged(tag{}, 42, other_tag{});
+static_assert(42 == my::get<1>(packed_tagged));
+static_assert(std::is_same_v<tag const&, decltype(my::get<0>(packed_tagged))>);
+
 int main(){}